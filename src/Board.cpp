@@ -16,6 +16,8 @@
 #include "StatusLed.hpp"
 #include "PhotoResistor.hpp"
 #include "RemoteControl.hpp"
+#include "device/AdcCapture.hpp"
+#include "device/SmokeSensor.hpp"
 
 
 Board::Board (boost::asio::io_context &context)
@@ -29,14 +31,25 @@ Board::Board (boost::asio::io_context &context)
 
         this->statusLed = std::make_unique<StatusLed>();
 
+        // Blinks until the server is connected
+        this->statusLed->updatePattern(STATUS_LED_PATTERN::BLINK, Board::STATUS_LED_BRIGHTNESS_PCT);
         this->statusLed->updateColor(this->statusColor);
     }
 
+    // Init adc capture, shared by the photoresistor and the smoke sensor
+    {
+        AdcCapture::Config config;
+        config.channelArray = { PhotoResistor::ADC_CHANNEL, SmokeSensor::ADC_CHANNEL };
+        config.blockSize    = AdcCapture::DEFAULT_BLOCK_SIZE;
+
+        this->adcCapture = std::make_shared<AdcCapture>(config, this->ioContext);
+    }
+
     // Init photoresistor
     {
         this->isPhotoResistorReading = false;
 
-        this->photoResistor = std::make_unique<PhotoResistor>();
+        this->photoResistor = std::make_unique<PhotoResistor>(this->adcCapture);
 
         auto asyncCallback = std::bind(&Board::updatePhotoResistorDataAsync, this);
         boost::asio::co_spawn(this->ioContext, std::move(asyncCallback), boost::asio::detached);
@@ -63,6 +76,8 @@ void Board::start ()
 {
     const auto nodeId = this->getNodeId();
 
+    constexpr NODE_CODEC codec = NODE_CODEC::JSON;     // The other nodes of the network decode JSON only
+
     // Alloc TCP Client
     {
         this->client = std::make_unique<TCP::Client>(this->ioContext);
@@ -72,6 +87,7 @@ void Board::start ()
     {
         Node::Config config;
         config.id                           = nodeId;
+        config.codec                        = codec;
         config.processRawMessageCallback    = std::bind(&TCP::Client::sendMessage, this->client.get(), std::placeholders::_1);
         config.processMessageCallback       = std::bind(&Board::receiveNodeMessage, this, std::placeholders::_1);
 
@@ -85,6 +101,12 @@ void Board::start ()
                     + std::to_string(node_ip_address[nodeId][2]) + "." + std::to_string(node_ip_address[nodeId][3]);
         config.port = static_cast<decltype(config.port)>(server_port);
         config.processMessageCallback = std::bind(&Node::addRawMessage, this->node.get(), std::placeholders::_1);
+        config.processConnectCallback = std::bind(&Board::processConnection, this);
+        config.processErrorCallback = std::bind(&Board::processDisconnection, this);
+
+        // Binary encoded messages may hold the text delimiter, so they are never sent in the text framing.
+        // Otherwise servers without the binary framing keep the text one
+        config.framing = (codec == NODE_CODEC::BINARY) ? TCP::FRAMING::BINARY : TCP::FRAMING::NEGOTIATED;
 
         this->client->start(config);
     }
@@ -107,6 +129,23 @@ void Board::receiveNodeMessage (NodeMsg message)
     return;
 }
 
+void Board::processConnection ()
+{
+    // The server may have been restarted, so the subscription is renewed on every connection
+    this->node->subscribe(this->getNodeSubscription());
+
+    this->statusLed->updatePattern(STATUS_LED_PATTERN::FLASH, Board::STATUS_LED_BRIGHTNESS_PCT);
+
+    return;
+}
+
+void Board::processDisconnection ()
+{
+    this->statusLed->updatePattern(STATUS_LED_PATTERN::BLINK, Board::STATUS_LED_BRIGHTNESS_PCT);
+
+    return;
+}
+
 void Board::updateStatusLed (STATUS_LED_COLOR color)
 {
     if (color == this->statusColor)
@@ -155,7 +194,7 @@ boost::asio::awaitable<void> Board::updatePhotoResistorDataAsync ()
                     this->photoResistorTimer.expires_from_now(boost::posix_time::milliseconds(iterationPeriodMS));
                     co_await this->photoResistorTimer.async_wait(boost::asio::use_awaitable);
 
-                    adcBuffer += this->photoResistor->readAdcValue();
+                    adcBuffer += co_await this->photoResistor->readAdcValueAsync();
                 }
 
                 dividerAdc_1 = adcBuffer / Board::PHOTORESISTOR_MEAUSEREMENT_COUNT;
@@ -219,3 +258,8 @@ std::int64_t Board::getCurrentTime () const
     
     return time.time_of_day().total_milliseconds();
 }
+
+std::shared_ptr<AdcCapture> Board::getAdcCapture () const noexcept
+{
+    return this->adcCapture;
+}
@@ -15,6 +15,7 @@
 
 class Node;
 class StatusLed;
+class AdcCapture;
 class PhotoResistor;
 class RemoteControl;
 
@@ -31,6 +32,8 @@ class Board
 
         static constexpr int64_t REMOTE_CONTROL_HYSTERESIS_MS = (1U * 1000U);
 
+        static constexpr std::size_t STATUS_LED_BRIGHTNESS_PCT = 100U;
+
     private:
         static constexpr std::size_t REMOTE_CONTROL_INT_GPIO = 22U;
 
@@ -56,9 +59,12 @@ class Board
         void sendNodeMessage (NodeMsg message);
         void updateStatusLed (STATUS_LED_COLOR color);
         std::int64_t getCurrentTime () const;
+        std::shared_ptr<AdcCapture> getAdcCapture () const noexcept;
 
     private:
         void receiveNodeMessage (NodeMsg message);
+        void processConnection ();
+        void processDisconnection ();
         void processRemoteControl (REMOTE_CONTROL_BUTTON button);
 
     private:
@@ -67,6 +73,7 @@ class Board
     private:
         virtual void processNodeMessage (NodeMsg message) = 0;
         virtual node_id_t getNodeId () const noexcept = 0;
+        virtual NodeCommandArray getNodeSubscription () const = 0;
         virtual std::size_t processPhotoResistorData (PhotoResistorData data) = 0;
         virtual bool disableLightning (std::size_t periodMS) = 0;
         virtual void processRemoteButton (REMOTE_CONTROL_BUTTON button) = 0;
@@ -82,6 +89,9 @@ class Board
         std::unique_ptr<StatusLed> statusLed;
         STATUS_LED_COLOR statusColor;
 
+    private:
+        std::shared_ptr<AdcCapture> adcCapture;
+
     private:
         boost::asio::deadline_timer photoResistorTimer;
         std::unique_ptr<PhotoResistor> photoResistor;
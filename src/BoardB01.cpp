@@ -34,6 +34,10 @@ BoardB01::BoardB01 (BoardB01::Config config, boost::asio::io_context &context)
 
     this->isLightningBlocked = false;
 
+    this->isStateUpdatePending  = false;
+    this->stateEventCount       = 0U;
+    this->stateEvaluationCount  = 0U;
+
     this->arePirsInitialized = false;
 
     // Init B01 node
@@ -75,13 +79,15 @@ BoardB01::BoardB01 (BoardB01::Config config, boost::asio::io_context &context)
     // Init smoke sensor
     {
         PeriodicSmokeSensor::Config config;
-        config.initWarmTimeS    = BoardB01::SMOKE_INIT_WARM_TIME_S;
-        config.warmTimeS        = BoardB01::SMOKE_WARM_TIME_S;
-        config.sampleCount      = BoardB01::SMOKE_SAMPLE_COUNT;
-        config.sampleTimeS      = BoardB01::SMOKE_SAMPLE_TIME_S;
-        config.sleepTimeMin     = NodeB01::SMOKE_PERIOD_MIN;
-        config.powerGpio        = BoardB01::SMOKE_SENSOR_POWER_GPIO;
-        config.processCallback  = std::bind(&BoardB01::processSmokeSensor, this, std::placeholders::_1);
+        config.initWarmTimeS     = BoardB01::SMOKE_INIT_WARM_TIME_S;
+        config.warmTimeS         = BoardB01::SMOKE_WARM_TIME_S;
+        config.sampleCount       = BoardB01::SMOKE_SAMPLE_COUNT;
+        config.sampleTimeS       = BoardB01::SMOKE_SAMPLE_TIME_S;
+        config.sleepTimeMin      = NodeB01::SMOKE_PERIOD_MIN;
+        config.powerGpio         = BoardB01::SMOKE_SENSOR_POWER_GPIO;
+        config.alarmThresholdAdc = NodeB01::SMOKE_THRESHOLD_ADC;
+        config.adcCapture        = this->getAdcCapture();
+        config.processCallback   = std::bind(&BoardB01::processSmokeSensor, this, std::placeholders::_1);
 
         this->smokeSensor = std::make_unique<PeriodicSmokeSensor>(config, this->ioContext);
         this->smokeSensor->start();
@@ -112,6 +118,47 @@ BoardB01::BoardB01 (BoardB01::Config config, boost::asio::io_context &context)
 BoardB01::~BoardB01 () = default;
 
 
+BoardB01::StateUpdateStatistics BoardB01::getStateUpdateStatistics () const noexcept
+{
+    StateUpdateStatistics statistics;
+    statistics.eventCount       = this->stateEventCount;
+    statistics.evaluationCount  = this->stateEvaluationCount;
+
+    return statistics;
+}
+
+// Any number of events before the next io_context turn result in a single evaluation
+void BoardB01::scheduleStateUpdate ()
+{
+    ++this->stateEventCount;
+
+    if (this->isStateUpdatePending == true)
+    {
+        return;
+    }
+
+    this->isStateUpdatePending = true;
+
+    auto asyncCallback = std::bind(&BoardB01::runStateUpdate, this);
+    boost::asio::post(this->ioContext, asyncCallback);
+
+    return;
+}
+
+void BoardB01::runStateUpdate ()
+{
+    // Cleared first, an event raised by the evaluation itself schedules the next one
+    this->isStateUpdatePending = false;
+
+    ++this->stateEvaluationCount;
+
+    BOOST_LOG_TRIVIAL(debug) << "Board B01 : state update, event count = " << this->stateEventCount << ", evaluation count = " << this->stateEvaluationCount;
+
+    this->updateState();
+
+    return;
+}
+
 void BoardB01::updateState ()
 {
     const auto timeMS = this->getCurrentTime();
@@ -158,9 +205,9 @@ void BoardB01::updateState ()
 
     if (state.isMessageToSend == true)
     {
-        const auto messages = this->node->extractMessages();
+        auto messages = this->node->extractMessages();
 
-        for (auto itr = std::cbegin(messages); itr != std::cend(messages); ++itr)
+        for (auto itr = std::begin(messages); itr != std::end(messages); ++itr)
         {
             this->sendNodeMessage(std::move(*itr));
         }
@@ -182,8 +229,7 @@ void BoardB01::processNodeMessage (NodeMsg message)
 
     this->node->processMessage(message, timeMS);
 
-    auto asyncCallback = std::bind(&BoardB01::updateState, this);
-    boost::asio::post(this->ioContext, asyncCallback);
+    this->scheduleStateUpdate();
 
     return;
 }
@@ -193,6 +239,11 @@ node_id_t BoardB01::getNodeId () const noexcept
     return this->node->getId();
 }
 
+NodeCommandArray BoardB01::getNodeSubscription () const
+{
+    return this->node->getSubscription();
+}
+
 std::size_t BoardB01::processPhotoResistorData (Board::PhotoResistorData data)
 {
     constexpr float gamma               = 0.70F;
@@ -208,8 +259,7 @@ std::size_t BoardB01::processPhotoResistorData (Board::PhotoResistorData data)
 
     this->node->processLuminosity(luminosity);
 
-    auto asyncCallback = std::bind(&BoardB01::updateState, this);
-    boost::asio::post(this->ioContext, asyncCallback);
+    this->scheduleStateUpdate();
 
     if (this->arePirsInitialized == false)
     {
@@ -222,7 +272,9 @@ std::size_t BoardB01::processPhotoResistorData (Board::PhotoResistorData data)
             GpioInt::Config config;
             config.gpio                 = BoardB01::DOOR_PIR_INT_GPIO;
             config.edge                 = GpioInt::EDGE::RISING;
-            config.interruptCallback    = std::bind(&BoardB01::processDoorPir, this);
+            config.backend              = GpioInt::BACKEND::CHARDEV;
+            config.batchTimeMS          = 0U;
+            config.interruptCallback    = std::bind(&BoardB01::processDoorPir, this, std::placeholders::_1);
 
             this->doorPir = std::make_unique<GpioInt>(config, this->ioContext);
         }
@@ -234,7 +286,9 @@ std::size_t BoardB01::processPhotoResistorData (Board::PhotoResistorData data)
             GpioInt::Config config;
             config.gpio                 = BoardB01::ROOM_PIR_INT_GPIO;
             config.edge                 = GpioInt::EDGE::RISING;
-            config.interruptCallback    = std::bind(&BoardB01::processRoomPir, this);
+            config.backend              = GpioInt::BACKEND::CHARDEV;
+            config.batchTimeMS          = 0U;
+            config.interruptCallback    = std::bind(&BoardB01::processRoomPir, this, std::placeholders::_1);
 
             this->roomPir = std::make_unique<GpioInt>(config, this->ioContext);
         }
@@ -271,8 +325,7 @@ void BoardB01::processRemoteButton (REMOTE_CONTROL_BUTTON button)
 
     this->node->processRemoteButton(button, timeMS);
 
-    auto asyncCallback = std::bind(&BoardB01::updateState, this);
-    boost::asio::post(this->ioContext, asyncCallback);
+    this->scheduleStateUpdate();
 
     return;
 }
@@ -281,8 +334,7 @@ void BoardB01::processHumiditySensor (PeriodicHumiditySensorData data)
 {
     this->node->processHumidity(data);
 
-    auto asyncCallback = std::bind(&BoardB01::updateState, this);
-    boost::asio::post(this->ioContext, asyncCallback);
+    this->scheduleStateUpdate();
 
     return;
 }
@@ -291,8 +343,7 @@ void BoardB01::processDustSensor (PeriodicDustSensorData data)
 {
     this->node->processDust(data);
 
-    auto asyncCallback = std::bind(&BoardB01::updateState, this);
-    boost::asio::post(this->ioContext, asyncCallback);
+    this->scheduleStateUpdate();
 
     return;
 }
@@ -301,45 +352,58 @@ void BoardB01::processSmokeSensor (PeriodicSmokeSensorData data)
 {
     this->node->processSmoke(data);
 
-    auto asyncCallback = std::bind(&BoardB01::updateState, this);
-    boost::asio::post(this->ioContext, asyncCallback);
+    this->scheduleStateUpdate();
 
     return;
 }
 
-void BoardB01::processDoorPir ()
+void BoardB01::processDoorPir (std::span<const std::uint64_t> edgeTimeArray)
 {
-    const auto timeMS = this->getCurrentTime();
+    if (edgeTimeArray.empty() == true)
+    {
+        return;
+    }
 
-    if ((timeMS - this->doorPirLastMS) > BoardB01::PIR_HYSTERESIS_MS)
+    // The latest edge of the batch is enough for the hysteresis
+    const auto edgeTimeMS = static_cast<int64_t>(edgeTimeArray.back() / 1000000U);
+
+    if ((edgeTimeMS - this->doorPirLastMS) > BoardB01::PIR_HYSTERESIS_MS)
     {
         BOOST_LOG_TRIVIAL(info) << "Board B01 : door pir event";
 
-        this->doorPirLastMS = timeMS;
+        this->doorPirLastMS = edgeTimeMS;
+
+        const auto timeMS = this->getCurrentTime();
 
         this->node->processDoorMovement(timeMS);
 
-        auto asyncCallback = std::bind(&BoardB01::updateState, this);
-        boost::asio::post(this->ioContext, asyncCallback);
+        this->scheduleStateUpdate();
     }
 
     return;
 }
 
-void BoardB01::processRoomPir ()
+void BoardB01::processRoomPir (std::span<const std::uint64_t> edgeTimeArray)
 {
-    const auto timeMS = this->getCurrentTime();
+    if (edgeTimeArray.empty() == true)
+    {
+        return;
+    }
 
-    if ((timeMS - this->roomPirLastMS) > BoardB01::PIR_HYSTERESIS_MS)
+    // The latest edge of the batch is enough for the hysteresis
+    const auto edgeTimeMS = static_cast<int64_t>(edgeTimeArray.back() / 1000000U);
+
+    if ((edgeTimeMS - this->roomPirLastMS) > BoardB01::PIR_HYSTERESIS_MS)
     {
         BOOST_LOG_TRIVIAL(info) << "Board B01 : room pir event";
 
-        this->roomPirLastMS = timeMS;
+        this->roomPirLastMS = edgeTimeMS;
+
+        const auto timeMS = this->getCurrentTime();
 
         this->node->processRoomMovement(timeMS);
 
-        auto asyncCallback = std::bind(&BoardB01::updateState, this);
-        boost::asio::post(this->ioContext, asyncCallback);
+        this->scheduleStateUpdate();
     }
 
     return;
@@ -6,6 +6,7 @@
 #ifndef BOARD_B01_H_
 #define BOARD_B01_H_
 
+#include <span>
 #include <filesystem>
 
 #include "Board.hpp"
@@ -59,6 +60,12 @@ class BoardB01 : public Board
             std::filesystem::path configDirectory;
         };
 
+        struct StateUpdateStatistics
+        {
+            std::size_t eventCount;         // Events which requested a state update
+            std::size_t evaluationCount;    // State updates actually performed
+        };
+
     public:
         explicit BoardB01 (Config config, boost::asio::io_context &context);
         BoardB01 (const BoardB01&) = delete;
@@ -67,14 +74,20 @@ class BoardB01 : public Board
         BoardB01& operator= (BoardB01&&) = delete;
         virtual ~BoardB01 ();
 
+    public:
+        StateUpdateStatistics getStateUpdateStatistics () const noexcept;
+
     private:
         virtual void processNodeMessage (NodeMsg message) override final;
         virtual node_id_t getNodeId () const noexcept override final;
+        virtual NodeCommandArray getNodeSubscription () const override final;
         virtual std::size_t processPhotoResistorData (PhotoResistorData data) override final;
         virtual bool disableLightning (std::size_t periodMS) override final;
         virtual void processRemoteButton (REMOTE_CONTROL_BUTTON button) override final;
 
     private:
+        void scheduleStateUpdate ();
+        void runStateUpdate ();
         void updateState ();
 
     private:
@@ -84,8 +97,8 @@ class BoardB01 : public Board
         void processHumiditySensor (PeriodicHumiditySensorData data);
         void processDustSensor (PeriodicDustSensorData data);
         void processSmokeSensor (PeriodicSmokeSensorData data);
-        void processDoorPir ();
-        void processRoomPir ();
+        void processDoorPir (std::span<const std::uint64_t> edgeTimeArray);
+        void processRoomPir (std::span<const std::uint64_t> edgeTimeArray);
 
     private:
         Config config;
@@ -109,12 +122,17 @@ class BoardB01 : public Board
         boost::asio::deadline_timer lightningBlockTimer;
         bool isLightningBlocked;
 
+    private:
+        bool isStateUpdatePending;
+        std::size_t stateEventCount;
+        std::size_t stateEvaluationCount;
+
     private:
         bool arePirsInitialized;
         std::unique_ptr<GpioInt> doorPir;
-        int64_t doorPirLastMS;
+        int64_t doorPirLastMS;  // Edge time of the gpio, CLOCK_MONOTONIC
         std::unique_ptr<GpioInt> roomPir;
-        int64_t roomPirLastMS;
+        int64_t roomPirLastMS;  // Edge time of the gpio, CLOCK_MONOTONIC
 
     private:
         struct Configuration
@@ -5,22 +5,134 @@
 
 #include "GpioInt.hpp"
 
+#include <chrono>
 #include <fstream>
 #include <filesystem>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
 
 #include <boost/asio/co_spawn.hpp>
 #include <boost/asio/detached.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/log/trivial.hpp>
 
 
 GpioInt::GpioInt (GpioInt::Config config, boost::asio::io_context &context)
 :
-    udpSocket { context }
+    udpSocket { context },
+    eventDescriptor { context },
+    batchTimer { context }
 {
     this->config = config;
 
-    this->fileDescriptor = (-1);
+    this->backend           = GpioInt::BACKEND::SYSFS;
+    this->fileDescriptor    = (-1);
+
+    if (this->config.backend == GpioInt::BACKEND::CHARDEV)
+    {
+        this->fileDescriptor = this->openChardev();
+
+        if (this->fileDescriptor >= 0)
+        {
+            this->backend = GpioInt::BACKEND::CHARDEV;
+        }
+        else
+        {
+            BOOST_LOG_TRIVIAL(warning) << "Gpio Int : gpio = " << this->config.gpio << ", chardev error = " << std::strerror(errno) << ", fallback to sysfs";
+        }
+    }
+
+    if (this->backend == GpioInt::BACKEND::SYSFS)
+    {
+        this->fileDescriptor = this->openSysfs();
+    }
+
+    if (this->fileDescriptor < 0)
+    {
+        throw std::runtime_error { "File open error" };
+    }
+
+    if (this->backend == GpioInt::BACKEND::CHARDEV)
+    {
+        // The descriptor owns the line request from now on
+        this->eventDescriptor.assign(this->fileDescriptor);
+
+        auto asyncCallback = std::bind(&GpioInt::readEventsAsync, this);
+        boost::asio::co_spawn(context, std::move(asyncCallback), boost::asio::detached);
+    }
+    else
+    {
+        uint8_t value;
+        [[maybe_unused]] ssize_t bytes = read(this->fileDescriptor, (void*)&value, 1U);
+
+        this->udpSocket.assign(boost::asio::ip::udp::v4(), this->fileDescriptor);
+
+        auto asyncCallback = std::bind(&GpioInt::readAsync, this);
+        boost::asio::co_spawn(context, std::move(asyncCallback), boost::asio::detached);
+    }
+
+    return;
+}
+
+GpioInt::~GpioInt ()
+{
+    if (this->backend == GpioInt::BACKEND::SYSFS)
+    {
+        close(this->fileDescriptor);
+    }
+
+    return;
+}
+
+
+// The edge events are timestamped by the kernel, in the CLOCK_MONOTONIC domain by default
+int GpioInt::openChardev () const
+{
+    const std::string chipPath = "/dev/gpiochip" + std::to_string(this->config.gpio / GpioInt::CHIP_LINE_COUNT);
+
+    const int chipDescriptor = open(chipPath.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (chipDescriptor < 0)
+    {
+        return (-1);
+    }
+
+    std::array<__u64, 4U> edgeArray;
+    edgeArray[GpioInt::EDGE::NONE]      = 0U;
+    edgeArray[GpioInt::EDGE::RISING]    = GPIO_V2_LINE_FLAG_EDGE_RISING;
+    edgeArray[GpioInt::EDGE::FALLING]   = GPIO_V2_LINE_FLAG_EDGE_FALLING;
+    edgeArray[GpioInt::EDGE::BOTH]      = GPIO_V2_LINE_FLAG_EDGE_RISING | GPIO_V2_LINE_FLAG_EDGE_FALLING;
+
+    gpio_v2_line_request request;
+    std::memset(&request, 0, sizeof(request));
 
-    const std::string gpio = std::to_string(config.gpio);
+    request.offsets[0]          = static_cast<__u32>(this->config.gpio % GpioInt::CHIP_LINE_COUNT);
+    request.config.flags        = GPIO_V2_LINE_FLAG_INPUT | edgeArray[this->config.edge];
+    request.num_lines           = 1U;
+    request.event_buffer_size   = static_cast<__u32>(GpioInt::EVENT_BATCH_SIZE);
+    std::strncpy(request.consumer, "beaglebone-node", sizeof(request.consumer) - 1U);
+
+    const int result = ioctl(chipDescriptor, GPIO_V2_GET_LINE_IOCTL, &request);
+
+    // The line request stays valid without the chip descriptor
+    close(chipDescriptor);
+
+    if (result < 0)
+    {
+        return (-1);
+    }
+
+    return request.fd;
+}
+
+int GpioInt::openSysfs () const
+{
+    const std::string gpio = std::to_string(this->config.gpio);
     const std::filesystem::path valuePath { "/sys/class/gpio/gpio" + gpio + "/value" };
     const std::filesystem::path directionPath { "/sys/class/gpio/gpio" + gpio + "/direction" };
     const std::filesystem::path edgePath { "/sys/class/gpio/gpio" + gpio + "/edge" };
@@ -53,32 +165,9 @@ GpioInt::GpioInt (GpioInt::Config config, boost::asio::io_context &context)
         dataStream << edgeArray[this->config.edge];
     }
 
-    this->fileDescriptor = open(valuePath.string().c_str(), O_RDONLY | O_NONBLOCK);
-
-    if (this->fileDescriptor < 0)
-    {
-        throw std::runtime_error { "File open error" };
-    }
-
-    uint8_t value;
-    [[maybe_unused]] ssize_t bytes = read(this->fileDescriptor, (void*)&value, 1U);
-
-    this->udpSocket.assign(boost::asio::ip::udp::v4(), this->fileDescriptor);
-
-    auto asyncCallback = std::bind(&GpioInt::readAsync, this);
-    boost::asio::co_spawn(context, std::move(asyncCallback), boost::asio::detached);
-
-    return;
-}
-
-GpioInt::~GpioInt ()
-{
-    close(this->fileDescriptor);
-
-    return;
+    return open(valuePath.string().c_str(), O_RDONLY | O_NONBLOCK);
 }
 
-
 boost::asio::awaitable<void> GpioInt::readAsync ()
 {
     while (true)
@@ -87,10 +176,46 @@ boost::asio::awaitable<void> GpioInt::readAsync ()
                                                 boost::asio::ip::udp::socket::message_out_of_band,
                                                 boost::asio::use_awaitable);
 
+        // Sysfs has no event time, the wake-up time is the closest one (steady clock is CLOCK_MONOTONIC)
+        const auto timeNS = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
         uint8_t value;
         [[maybe_unused]] ssize_t bytes = read(this->fileDescriptor, (void*)&value, 1U);
         
-        this->config.interruptCallback();
+        const std::array<std::uint64_t, 1U> timeArray { static_cast<std::uint64_t>(timeNS) };
+
+        this->config.interruptCallback(timeArray);
+    }
+
+    co_return;
+}
+
+// A single read fetches every edge queued since the last wake-up, the kernel keeps them meanwhile
+boost::asio::awaitable<void> GpioInt::readEventsAsync ()
+{
+    std::array<gpio_v2_line_event, GpioInt::EVENT_BATCH_SIZE> eventArray;
+    std::array<std::uint64_t, GpioInt::EVENT_BATCH_SIZE> timeArray;
+
+    while (true)
+    {
+        co_await this->eventDescriptor.async_wait(boost::asio::posix::stream_descriptor::wait_read, boost::asio::use_awaitable);
+
+        if (this->config.batchTimeMS > 0U)
+        {
+            this->batchTimer.expires_from_now(boost::posix_time::milliseconds(this->config.batchTimeMS));
+            co_await this->batchTimer.async_wait(boost::asio::use_awaitable);
+        }
+
+        const std::size_t bytes = co_await this->eventDescriptor.async_read_some(boost::asio::buffer(eventArray), boost::asio::use_awaitable);
+
+        const std::size_t eventCount = bytes / sizeof(gpio_v2_line_event);
+
+        for (std::size_t i = 0U; i < eventCount; ++i)
+        {
+            timeArray[i] = static_cast<std::uint64_t>(eventArray[i].timestamp_ns);
+        }
+
+        this->config.interruptCallback(std::span<const std::uint64_t> { timeArray.data(), eventCount });
     }
 
     co_return;
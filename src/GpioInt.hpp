@@ -6,11 +6,24 @@
 #ifndef GPIO_INT_H_
 #define GPIO_INT_H_
 
+#include <span>
+#include <array>
+#include <cstdint>
+
 #include <boost/asio/ip/udp.hpp>
+#include <boost/asio/deadline_timer.hpp>
+#include <boost/asio/posix/stream_descriptor.hpp>
 #include <boost/asio/awaitable.hpp>
 
 class GpioInt
 {
+    public:
+        // Lines of the character device, the sysfs gpio number N is the line (N % 32) of /dev/gpiochip(N / 32)
+        static constexpr std::size_t CHIP_LINE_COUNT = 32U;
+
+        // Edges fetched by a single read of the character device, a whole NEC frame fits
+        static constexpr std::size_t EVENT_BATCH_SIZE = 64U;
+
     public:
         enum EDGE : std::size_t
         {
@@ -20,11 +33,19 @@ class GpioInt
             BOTH
         };
 
+        enum BACKEND : std::size_t
+        {
+            SYSFS = 0,
+            CHARDEV     // Falls back to sysfs, if the line can not be requested
+        };
+
         struct Config
         {
             std::size_t gpio;
             EDGE edge;
-            std::function<void()> interruptCallback;
+            BACKEND backend;
+            std::size_t batchTimeMS;    // Delay after the first edge, so the following ones are fetched by the same read (chardev only)
+            std::function<void(std::span<const std::uint64_t>)> interruptCallback;  // Edge times, CLOCK_MONOTONIC nanoseconds
         };
 
     public:
@@ -35,15 +56,23 @@ class GpioInt
         GpioInt& operator= (GpioInt&&) = delete;
         ~GpioInt ();
 
+    private:
+        int openChardev () const;
+        int openSysfs () const;
+
     private:
         boost::asio::awaitable<void> readAsync ();
+        boost::asio::awaitable<void> readEventsAsync ();
 
     private:
         Config config;
 
     private:
+        BACKEND backend;
         int fileDescriptor;
         boost::asio::ip::udp::socket udpSocket;
+        boost::asio::posix::stream_descriptor eventDescriptor;
+        boost::asio::deadline_timer batchTimer;
 };
 
 #endif // GPIO_INT_H_
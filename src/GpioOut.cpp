@@ -7,55 +7,148 @@
 
 #include <fstream>
 #include <filesystem>
-#include <sstream>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+
+#include <boost/log/trivial.hpp>
 
 
 GpioOut::GpioOut (GpioOut::Config config)
 {
-    std::stringstream pathStream; 
-    pathStream << "/sys/class/gpio/gpio" << config.gpio;
+    this->config = config;
 
-    this->valuePath = pathStream.str() + "/value";
+    this->backend           = GpioOut::BACKEND::SYSFS;
+    this->fileDescriptor    = (-1);
 
-    const std::string directionPath = pathStream.str() + "/direction"; 
-
-    const std::string exportPath = "/sys/class/gpio/export";
+    if (this->config.backend == GpioOut::BACKEND::CHARDEV)
+    {
+        this->fileDescriptor = this->openChardev();
+
+        if (this->fileDescriptor >= 0)
+        {
+            this->backend = GpioOut::BACKEND::CHARDEV;
+        }
+        else
+        {
+            BOOST_LOG_TRIVIAL(warning) << "Gpio Out : gpio = " << this->config.gpio << ", chardev error = " << std::strerror(errno) << ", fallback to sysfs";
+        }
+    }
 
-    // Try to enable gpio
-    if (std::filesystem::path valuePath = this->valuePath; std::filesystem::exists(valuePath) != true)
+    if (this->backend == GpioOut::BACKEND::SYSFS)
     {
-        std::ofstream dataStream;
-        dataStream.open(exportPath, std::ofstream::out);
-        dataStream << config.gpio;
+        this->fileDescriptor = this->openSysfs();
     }
 
-    // Setup gpio direction
+    if (this->fileDescriptor < 0)
     {
-        std::ofstream dataStream;
-        dataStream.open(directionPath, std::ofstream::out);
-        dataStream << "out";
+        throw std::runtime_error { "File open error" };
     }
 
     return;
 }
 
-GpioOut::~GpioOut () = default;
+GpioOut::~GpioOut ()
+{
+    close(this->fileDescriptor);
+
+    return;
+}
 
 
 void GpioOut::setHigh () const
 {
-    std::ofstream dataStream;
-    dataStream.open(this->valuePath, std::ofstream::out);
-    dataStream << 1U;
+    this->setValue(1U);
 
     return;
 }
 
 void GpioOut::setLow () const
 {
-    std::ofstream dataStream;
-    dataStream.open(this->valuePath, std::ofstream::out);
-    dataStream << 0U;
+    this->setValue(0U);
+
+    return;
+}
+
+// The line is requested as output and driven low, as the sysfs direction "out" does
+int GpioOut::openChardev () const
+{
+    const std::string chipPath = "/dev/gpiochip" + std::to_string(this->config.gpio / GpioOut::CHIP_LINE_COUNT);
+
+    const int chipDescriptor = open(chipPath.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (chipDescriptor < 0)
+    {
+        return (-1);
+    }
+
+    gpiohandle_request request;
+    std::memset(&request, 0, sizeof(request));
+
+    request.lineoffsets[0]      = static_cast<__u32>(this->config.gpio % GpioOut::CHIP_LINE_COUNT);
+    request.flags               = GPIOHANDLE_REQUEST_OUTPUT;
+    request.default_values[0]   = 0U;
+    request.lines               = 1U;
+    std::strncpy(request.consumer_label, "beaglebone-node", sizeof(request.consumer_label) - 1U);
+
+    const int result = ioctl(chipDescriptor, GPIO_GET_LINEHANDLE_IOCTL, &request);
+
+    // The line handle stays valid without the chip descriptor
+    close(chipDescriptor);
+
+    if (result < 0)
+    {
+        return (-1);
+    }
+
+    return request.fd;
+}
+
+int GpioOut::openSysfs () const
+{
+    const std::string gpio = std::to_string(this->config.gpio);
+    const std::filesystem::path valuePath { "/sys/class/gpio/gpio" + gpio + "/value" };
+    const std::filesystem::path directionPath { "/sys/class/gpio/gpio" + gpio + "/direction" };
+
+    // Try to enable gpio
+    if (std::filesystem::exists(valuePath) != true)
+    {
+        std::ofstream dataStream;
+        dataStream.open("/sys/class/gpio/export", std::ofstream::out);
+        dataStream << this->config.gpio;
+    }
+
+    // Setup gpio direction
+    {
+        std::ofstream dataStream;
+        dataStream.open(directionPath, std::ofstream::out);
+        dataStream << "out";
+    }
+
+    return open(valuePath.string().c_str(), O_WRONLY | O_CLOEXEC);
+}
+
+void GpioOut::setValue (std::uint8_t value) const
+{
+    if (this->backend == GpioOut::BACKEND::CHARDEV)
+    {
+        gpiohandle_data data;
+        std::memset(&data, 0, sizeof(data));
+
+        data.values[0] = value;
+
+        [[maybe_unused]] const int result = ioctl(this->fileDescriptor, GPIOHANDLE_SET_LINE_VALUES_IOCTL, &data);
+    }
+    else
+    {
+        const char symbol = (value != 0U) ? '1' : '0';
+
+        [[maybe_unused]] const ssize_t bytes = pwrite(this->fileDescriptor, &symbol, 1U, 0);
+    }
 
     return;
 }
@@ -8,13 +8,25 @@
 
 #include <string>
 #include <cstddef>
+#include <cstdint>
 
 class GpioOut
 {
     public:
+        // Lines of the character device, the sysfs gpio number N is the line (N % 32) of /dev/gpiochip(N / 32)
+        static constexpr std::size_t CHIP_LINE_COUNT = 32U;
+
+    public:
+        enum BACKEND : std::size_t
+        {
+            SYSFS = 0,
+            CHARDEV     // Falls back to sysfs, if the line can not be requested
+        };
+
         struct Config
         {
             std::size_t gpio;
+            BACKEND backend;
         };
 
     public:
@@ -30,7 +42,16 @@ class GpioOut
         void setLow () const;
 
     private:
-        std::string valuePath;
+        int openChardev () const;
+        int openSysfs () const;
+        void setValue (std::uint8_t value) const;
+
+    private:
+        Config config;
+
+    private:
+        BACKEND backend;
+        int fileDescriptor;     // Value file or line handle, open for the lifetime
 };
 
 #endif // GPIO_OUT_H_
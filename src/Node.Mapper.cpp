@@ -6,15 +6,284 @@
 #include "Node.Mapper.hpp"
 
 #include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
 
-#include <boost/lexical_cast.hpp>
-#include <boost/property_tree/ptree.hpp>
-#include <boost/property_tree/json_parser.hpp>
 
+// Binary layout :
+//  marker, source, destination count, destinations, command, data count,
+//  data = key, type, value
+// A subscription has no destination and the subscription command, followed by a command count and the commands.
+// Integers are unsigned LEB128 varints (signed values zigzag encoded),
+// floats are IEEE 754 little-endian, strings are a varint length and the bytes.
+// A key is an index of the interned key array, or a literal string after the literal key tag.
+static constexpr std::uint8_t binaryMarker = 0x01U;     // Never starts a JSON text
+static constexpr std::uint8_t literalKey = 0xFFU;
 
-static NodeMsgHeader deserializeHeader (const boost::property_tree::ptree &root);
+// The order is a part of the wire format, new keys are appended only
+static constexpr std::array<std::string_view, 8U> internedKeyArray
+{
+    "value_id",
+    "temp_c",
+    "hum_pct",
+    "pres_hpa",
+    "door_state",
+    "major",
+    "minor",
+    "patch"
+};
+
+enum class BINARY_DATA_TYPE : std::uint8_t
+{
+    INT = 0U,
+    FLOAT,
+    STRING
+};
+
+// The JSON reader walks the raw data once and writes straight into the message,
+// every function consumes the parsed part of the view
+static constexpr std::size_t maxJsonDepth = 16U;
+
+static std::string serializeJson (const NodeMsg &msg);
+static std::string serializeBinary (const NodeMsg &msg);
+static NODE_MAPPER_ERROR deserializeJson (std::string_view rawData, NodeMsgHeader &header, std::uint32_t *cmdID, NodeDataArray *dataArray,
+                                           NodeCommandArray *subArray);
+static NODE_MAPPER_ERROR deserializeBinaryHeader (std::string_view &rawData, NodeMsgHeader &header);
+static NODE_MAPPER_ERROR deserializeBinaryMessage (std::string_view rawData, NodeMsg &msg);
+static bool isBinary (std::string_view rawData) noexcept;
+
+static void skipJsonSpace (std::string_view &json) noexcept;
+static NODE_MAPPER_ERROR expectJson (std::string_view &json, char symbol) noexcept;
+static NODE_MAPPER_ERROR readJsonString (std::string_view &json, std::string_view &value, bool &isEscaped) noexcept;
+static NODE_MAPPER_ERROR readJsonNumber (std::string_view &json, NodeData &value);
+static NODE_MAPPER_ERROR readJsonInt (std::string_view &json, int &value) noexcept;
+template <typename IdArray>
+static NODE_MAPPER_ERROR readJsonIdArray (std::string_view &json, IdArray &idArray);
+static NODE_MAPPER_ERROR readJsonData (std::string_view &json, NodeDataArray &dataArray);
+static NODE_MAPPER_ERROR skipJsonValue (std::string_view &json) noexcept;
+static NODE_MAPPER_ERROR unescapeJsonString (std::string_view value, std::string &result);
+
+static void writeVarint (std::string &rawData, std::uint32_t value);
+static void writeString (std::string &rawData, std::string_view value);
+static NODE_MAPPER_ERROR readVarint (std::string_view &rawData, std::uint32_t &value) noexcept;
+static NODE_MAPPER_ERROR readByte (std::string_view &rawData, std::uint8_t &value) noexcept;
+static NODE_MAPPER_ERROR readString (std::string_view &rawData, std::string_view &value) noexcept;
+
+std::string serialize (const NodeMsg &msg, NODE_CODEC codec)
+{
+    if (codec == NODE_CODEC::BINARY)
+    {
+        return serializeBinary(msg);
+    }
+
+    return serializeJson(msg);
+}
+
+NODE_MAPPER_ERROR deserializeHeader (std::string_view rawData, NodeMsgHeader &header)
+{
+    if (isBinary(rawData) == true)
+    {
+        return deserializeBinaryHeader(rawData, header);
+    }
+
+    return deserializeJson(rawData, header, nullptr, nullptr, nullptr);
+}
+
+NODE_MAPPER_ERROR deserializeRoute (std::string_view rawData, NodeMsgHeader &header, std::uint32_t &cmdID)
+{
+    if (isBinary(rawData) == true)
+    {
+        if (const auto error = deserializeBinaryHeader(rawData, header); error != NODE_MAPPER_ERROR::NONE)
+        {
+            return error;
+        }
+
+        return readVarint(rawData, cmdID);
+    }
+
+    return deserializeJson(rawData, header, &cmdID, nullptr, nullptr);
+}
+
+NODE_MAPPER_ERROR deserializeMessage (std::string_view rawData, NodeMsg &msg)
+{
+    if (isBinary(rawData) == true)
+    {
+        return deserializeBinaryMessage(rawData, msg);
+    }
+
+    std::uint32_t command;
+
+    if (const auto error = deserializeJson(rawData, msg.header, &command, &msg.dataArray, nullptr); error != NODE_MAPPER_ERROR::NONE)
+    {
+        return error;
+    }
+
+    return toNodeCommand(command, msg.cmdID);
+}
+
+std::string serializeSubscription (const NodeSubscription &subscription, NODE_CODEC codec)
+{
+    if (codec == NODE_CODEC::BINARY)
+    {
+        std::string rawData;
+        rawData.reserve(8U + std::size(subscription.cmdArray));
+
+        rawData.push_back(static_cast<char>(binaryMarker));
+        writeVarint(rawData, static_cast<std::uint32_t>(subscription.source));
+        writeVarint(rawData, 0U);
+        writeVarint(rawData, NODE_SUBSCRIBE_CMD_ID);
+        writeVarint(rawData, static_cast<std::uint32_t>(std::size(subscription.cmdArray)));
+
+        for (auto itr = std::cbegin(subscription.cmdArray); itr != std::cend(subscription.cmdArray); ++itr)
+        {
+            writeVarint(rawData, static_cast<std::uint32_t>(*itr));
+        }
+
+        return rawData;
+    }
+
+    std::ostringstream stringStream;
+    stringStream << "{\"src_id\":" << subscription.source << ",\"dst_id\":[],\"cmd_id\":" << NODE_SUBSCRIBE_CMD_ID << ",\"sub_cmd_id\":[";
+
+    for (auto itr = std::cbegin(subscription.cmdArray); itr != std::cend(subscription.cmdArray); ++itr)
+    {
+        stringStream << *itr;
+
+        if (std::next(itr) != std::cend(subscription.cmdArray))
+        {
+            stringStream << ",";
+        }
+    }
+    stringStream << "]}";
+
+    std::string rawData = stringStream.str();
+
+    return rawData;
+}
+
+NODE_MAPPER_ERROR deserializeSubscription (std::string_view rawData, NodeSubscription &subscription)
+{
+    NodeMsgHeader header;
+    subscription.cmdArray.clear();
+
+    if (isBinary(rawData) == true)
+    {
+        std::uint32_t command;
+        std::uint32_t cmdCount;
+
+        if (const auto error = deserializeBinaryHeader(rawData, header); error != NODE_MAPPER_ERROR::NONE)
+        {
+            return error;
+        }
+
+        if (const auto error = readVarint(rawData, command); error != NODE_MAPPER_ERROR::NONE)
+        {
+            return error;
+        }
+
+        if (command != NODE_SUBSCRIBE_CMD_ID)
+        {
+            return NODE_MAPPER_ERROR::UNKNOWN_COMMAND;
+        }
+
+        if (const auto error = readVarint(rawData, cmdCount); error != NODE_MAPPER_ERROR::NONE)
+        {
+            return error;
+        }
+
+        for (std::uint32_t i = 0U; i < cmdCount; ++i)
+        {
+            std::uint32_t rawCommand;
+            node_command_id_t cmdID;
+
+            if (const auto error = readVarint(rawData, rawCommand); error != NODE_MAPPER_ERROR::NONE)
+            {
+                return error;
+            }
+
+            if (const auto error = toNodeCommand(rawCommand, cmdID); error != NODE_MAPPER_ERROR::NONE)
+            {
+                return error;
+            }
+
+            subscription.cmdArray.emplace(cmdID);
+        }
+    }
+    else
+    {
+        std::uint32_t command;
+
+        if (const auto error = deserializeJson(rawData, header, &command, nullptr, &subscription.cmdArray); error != NODE_MAPPER_ERROR::NONE)
+        {
+            return error;
+        }
+
+        if (command != NODE_SUBSCRIBE_CMD_ID)
+        {
+            return NODE_MAPPER_ERROR::UNKNOWN_COMMAND;
+        }
+    }
+
+    subscription.source = header.source;
+
+    return NODE_MAPPER_ERROR::NONE;
+}
+
+// node_command_id_t has no fixed underlying type, only the values of the node command list may be cast to it
+NODE_MAPPER_ERROR toNodeCommand (std::uint32_t command, node_command_id_t &cmdID) noexcept
+{
+    if (command > static_cast<std::uint32_t>(RESPONSE_VERSION))
+    {
+        return NODE_MAPPER_ERROR::UNKNOWN_COMMAND;
+    }
+
+    cmdID = static_cast<node_command_id_t>(command);
+
+    return NODE_MAPPER_ERROR::NONE;
+}
+
+const char* toString (NODE_MAPPER_ERROR error) noexcept
+{
+    switch (error)
+    {
+        case NODE_MAPPER_ERROR::NONE :
+            return "none";
+
+        case NODE_MAPPER_ERROR::UNEXPECTED_END :
+            return "unexpected end of message";
 
-std::string serialize (const NodeMsg &msg)
+        case NODE_MAPPER_ERROR::UNEXPECTED_CHARACTER :
+            return "unexpected character";
+
+        case NODE_MAPPER_ERROR::INVALID_NUMBER :
+            return "invalid number";
+
+        case NODE_MAPPER_ERROR::INVALID_STRING :
+            return "invalid string";
+
+        case NODE_MAPPER_ERROR::MISSING_FIELD :
+            return "missing field";
+
+        case NODE_MAPPER_ERROR::TOO_DEEP :
+            return "too deep nesting";
+
+        case NODE_MAPPER_ERROR::UNKNOWN_KEY :
+            return "unknown interned key";
+
+        case NODE_MAPPER_ERROR::UNKNOWN_TYPE :
+            return "unknown data type";
+
+        case NODE_MAPPER_ERROR::UNKNOWN_COMMAND :
+            return "unknown command";
+    }
+
+    return "unknown error";
+}
+
+std::string serializeJson (const NodeMsg &msg)
 {
     std::ostringstream stringStream;
     stringStream << "{\"src_id\":" << msg.header.source << ",\"dst_id\":[";
@@ -59,93 +328,970 @@ std::string serialize (const NodeMsg &msg)
     return rawData;
 }
 
-NodeMsgHeader deserializeHeader (const std::string &rawData)
+NODE_MAPPER_ERROR deserializeJson (std::string_view rawData, NodeMsgHeader &header, std::uint32_t *cmdID, NodeDataArray *dataArray,
+                                   NodeCommandArray *subArray)
 {
-    std::istringstream stringStream { rawData };
+    bool isSourceFound  = false;
+    bool isDestFound    = false;
+    bool isCommandFound = false;
+    bool isDataFound    = false;
+    bool isSubFound     = false;
 
-    boost::property_tree::ptree root;
-    boost::property_tree::json_parser::read_json(stringStream, root);
+    std::string_view json = rawData;
 
-    return deserializeHeader(root);
-}
+    if (const auto error = expectJson(json, '{'); error != NODE_MAPPER_ERROR::NONE)
+    {
+        return error;
+    }
 
-NodeMsgHeader deserializeHeader (const boost::property_tree::ptree &root)
-{
-    NodeMsgHeader header;
-    header.source = static_cast<node_id_t>(root.get<int>("src_id"));
+    skipJsonSpace(json);
 
-    const boost::property_tree::ptree &destArray = root.get_child("dst_id");
+    if ((json.empty() != true) && (json.front() == '}'))
+    {
+        return NODE_MAPPER_ERROR::MISSING_FIELD;
+    }
 
-    for (auto itr = std::cbegin(destArray); itr != std::cend(destArray); ++itr)
+    while (true)
     {
-        const auto &[key, value] = *itr;
-        header.destArray.emplace(static_cast<node_id_t>(value.get_value<int>()));
+        skipJsonSpace(json);
+
+        std::string_view key;
+        bool isEscaped;
+
+        if (const auto error = readJsonString(json, key, isEscaped); error != NODE_MAPPER_ERROR::NONE)
+        {
+            return error;
+        }
+
+        if (const auto error = expectJson(json, ':'); error != NODE_MAPPER_ERROR::NONE)
+        {
+            return error;
+        }
+
+        skipJsonSpace(json);
+
+        NODE_MAPPER_ERROR error = NODE_MAPPER_ERROR::NONE;
+
+        if (key == "src_id")
+        {
+            int source = 0;
+            error = readJsonInt(json, source);
+            header.source = static_cast<node_id_t>(source);
+            isSourceFound = true;
+        }
+        else if (key == "dst_id")
+        {
+            header.destArray.clear();
+            error = readJsonIdArray(json, header.destArray);
+            isDestFound = true;
+        }
+        else if ((key == "cmd_id") && (cmdID != nullptr))
+        {
+            int command = 0;
+            error = readJsonInt(json, command);
+
+            if ((error == NODE_MAPPER_ERROR::NONE) && (command < 0))
+            {
+                error = NODE_MAPPER_ERROR::INVALID_NUMBER;
+            }
+
+            *cmdID = static_cast<std::uint32_t>(command);
+            isCommandFound = true;
+        }
+        else if ((key == "data") && (dataArray != nullptr))
+        {
+            dataArray->clear();
+            error = readJsonData(json, *dataArray);
+            isDataFound = true;
+        }
+        else if ((key == "sub_cmd_id") && (subArray != nullptr))
+        {
+            // Read raw, every command is checked before the cast
+            std::set<std::uint32_t> rawArray;
+            subArray->clear();
+            error = readJsonIdArray(json, rawArray);
+
+            for (auto itr = std::cbegin(rawArray); (itr != std::cend(rawArray)) && (error == NODE_MAPPER_ERROR::NONE); ++itr)
+            {
+                node_command_id_t subCommand;
+                error = toNodeCommand(*itr, subCommand);
+
+                if (error == NODE_MAPPER_ERROR::NONE)
+                {
+                    subArray->emplace(subCommand);
+                }
+            }
+
+            isSubFound = true;
+        }
+        else
+        {
+            error = skipJsonValue(json);
+        }
+
+        if (error != NODE_MAPPER_ERROR::NONE)
+        {
+            return error;
+        }
+
+        // Without the data the message is read lazily, the rest of it is neither scanned nor validated
+        if ((dataArray == nullptr) && (subArray == nullptr) && (isSourceFound == true) && (isDestFound == true) && ((cmdID == nullptr) || (isCommandFound == true)))
+        {
+            return NODE_MAPPER_ERROR::NONE;
+        }
+
+        skipJsonSpace(json);
+
+        if (json.empty() == true)
+        {
+            return NODE_MAPPER_ERROR::UNEXPECTED_END;
+        }
+
+        const char symbol = json.front();
+        json.remove_prefix(1U);
+
+        if (symbol == '}')
+        {
+            break;
+        }
+
+        if (symbol != ',')
+        {
+            return NODE_MAPPER_ERROR::UNEXPECTED_CHARACTER;
+        }
+    }
+
+    skipJsonSpace(json);
+
+    if (json.empty() != true)
+    {
+        return NODE_MAPPER_ERROR::UNEXPECTED_CHARACTER;
+    }
+
+    if ((isSourceFound != true) || (isDestFound != true))
+    {
+        return NODE_MAPPER_ERROR::MISSING_FIELD;
+    }
+
+    if (((cmdID != nullptr) && (isCommandFound != true)) || ((dataArray != nullptr) && (isDataFound != true)))
+    {
+        return NODE_MAPPER_ERROR::MISSING_FIELD;
+    }
+
+    if ((subArray != nullptr) && (isSubFound != true))
+    {
+        return NODE_MAPPER_ERROR::MISSING_FIELD;
     }
 
-    return header;
+    return NODE_MAPPER_ERROR::NONE;
 }
 
-NodeMsg deserializeMessage (const std::string &rawData)
+std::string serializeBinary (const NodeMsg &msg)
 {
-    std::istringstream stringStream { rawData };
+    std::string rawData;
+    rawData.reserve(16U + std::size(msg.header.destArray) + (std::size(msg.dataArray) * 8U));
 
-    boost::property_tree::ptree root;
-    boost::property_tree::json_parser::read_json(stringStream, root);
+    rawData.push_back(static_cast<char>(binaryMarker));
+    writeVarint(rawData, static_cast<std::uint32_t>(msg.header.source));
+    writeVarint(rawData, static_cast<std::uint32_t>(std::size(msg.header.destArray)));
 
-    NodeMsg msg;
-    msg.header = deserializeHeader(root);
-
-    msg.cmdID = static_cast<node_command_id_t>(root.get<int>("cmd_id"));
+    for (auto itr = std::cbegin(msg.header.destArray); itr != std::cend(msg.header.destArray); ++itr)
+    {
+        writeVarint(rawData, static_cast<std::uint32_t>(*itr));
+    }
 
-    const boost::property_tree::ptree &cmdData = root.get_child("data");
+    writeVarint(rawData, static_cast<std::uint32_t>(msg.cmdID));
+    writeVarint(rawData, static_cast<std::uint32_t>(std::size(msg.dataArray)));
 
-    for (auto itr = std::cbegin(cmdData); itr != std::cend(cmdData); ++itr)
+    for (auto itr = std::cbegin(msg.dataArray); itr != std::cend(msg.dataArray); ++itr)
     {
         const auto &[key, value] = *itr;
 
-        NodeData data;
-        bool isCasted = false;
+        const auto keyItr = std::find(std::cbegin(internedKeyArray), std::cend(internedKeyArray), key);
 
-        if (isCasted != true)
+        if (keyItr != std::cend(internedKeyArray))
         {
-            try
-            {
-                data = boost::lexical_cast<int>(value.data());
-                isCasted = true;
-            }
-            catch (const boost::bad_lexical_cast &exp)
-            {
-                // Do nothing
-            }
+            rawData.push_back(static_cast<char>(std::distance(std::cbegin(internedKeyArray), keyItr)));
+        }
+        else
+        {
+            rawData.push_back(static_cast<char>(literalKey));
+            writeString(rawData, key);
         }
 
-        if (isCasted != true)
+        if (std::holds_alternative<int>(value) == true)
         {
-            try
-            {
-                data = boost::lexical_cast<float>(value.data());
-                isCasted = true;
-            }
-            catch (const boost::bad_lexical_cast &exp)
-            {
-                // Do nothing
-            }
+            const std::int32_t data = std::get<int>(value);
+            const std::uint32_t zigzag = (static_cast<std::uint32_t>(data) << 1U) ^ static_cast<std::uint32_t>(data >> 31);
+
+            rawData.push_back(static_cast<char>(BINARY_DATA_TYPE::INT));
+            writeVarint(rawData, zigzag);
         }
+        else if (std::holds_alternative<float>(value) == true)
+        {
+            const std::uint32_t data = std::bit_cast<std::uint32_t>(std::get<float>(value));
 
-        if (isCasted != true)
+            rawData.push_back(static_cast<char>(BINARY_DATA_TYPE::FLOAT));
+            rawData.push_back(static_cast<char>(data & 0xFFU));
+            rawData.push_back(static_cast<char>((data >> 8U) & 0xFFU));
+            rawData.push_back(static_cast<char>((data >> 16U) & 0xFFU));
+            rawData.push_back(static_cast<char>((data >> 24U) & 0xFFU));
+        }
+        else if (std::holds_alternative<std::string>(value) == true)
         {
-            try
-            {
-                data = boost::lexical_cast<std::string>(value.data());
-            }
-            catch (const boost::bad_lexical_cast &exp)
-            {
-                // Do nothing
-            }
+            rawData.push_back(static_cast<char>(BINARY_DATA_TYPE::STRING));
+            writeString(rawData, std::get<std::string>(value));
+        }
+    }
+
+    return rawData;
+}
+
+NODE_MAPPER_ERROR deserializeBinaryHeader (std::string_view &rawData, NodeMsgHeader &header)
+{
+    std::uint8_t marker;
+    std::uint32_t source;
+    std::uint32_t destCount;
+
+    if (const auto error = readByte(rawData, marker); error != NODE_MAPPER_ERROR::NONE)
+    {
+        return error;
+    }
+
+    if (const auto error = readVarint(rawData, source); error != NODE_MAPPER_ERROR::NONE)
+    {
+        return error;
+    }
+
+    if (const auto error = readVarint(rawData, destCount); error != NODE_MAPPER_ERROR::NONE)
+    {
+        return error;
+    }
+
+    header.source = static_cast<node_id_t>(source);
+    header.destArray.clear();
+
+    for (std::uint32_t i = 0U; i < destCount; ++i)
+    {
+        std::uint32_t dest;
+
+        if (const auto error = readVarint(rawData, dest); error != NODE_MAPPER_ERROR::NONE)
+        {
+            return error;
         }
 
-        msg.dataArray.emplace(key, data);
+        header.destArray.emplace(static_cast<node_id_t>(dest));
+    }
+
+    return NODE_MAPPER_ERROR::NONE;
+}
+
+NODE_MAPPER_ERROR deserializeBinaryMessage (std::string_view rawData, NodeMsg &msg)
+{
+    std::uint32_t command;
+    std::uint32_t dataCount;
+
+    if (const auto error = deserializeBinaryHeader(rawData, msg.header); error != NODE_MAPPER_ERROR::NONE)
+    {
+        return error;
+    }
+
+    if (const auto error = readVarint(rawData, command); error != NODE_MAPPER_ERROR::NONE)
+    {
+        return error;
+    }
+
+    if (const auto error = readVarint(rawData, dataCount); error != NODE_MAPPER_ERROR::NONE)
+    {
+        return error;
     }
 
-    return msg;
+    if (const auto error = toNodeCommand(command, msg.cmdID); error != NODE_MAPPER_ERROR::NONE)
+    {
+        return error;
+    }
+
+    msg.dataArray.clear();
+
+    for (std::uint32_t i = 0U; i < dataCount; ++i)
+    {
+        std::uint8_t keyIndex;
+        std::string_view key;
+
+        if (const auto error = readByte(rawData, keyIndex); error != NODE_MAPPER_ERROR::NONE)
+        {
+            return error;
+        }
+
+        if (keyIndex == literalKey)
+        {
+            if (const auto error = readString(rawData, key); error != NODE_MAPPER_ERROR::NONE)
+            {
+                return error;
+            }
+        }
+        else if (keyIndex < std::size(internedKeyArray))
+        {
+            key = internedKeyArray[keyIndex];
+        }
+        else
+        {
+            return NODE_MAPPER_ERROR::UNKNOWN_KEY;
+        }
+
+        std::uint8_t type;
+
+        if (const auto error = readByte(rawData, type); error != NODE_MAPPER_ERROR::NONE)
+        {
+            return error;
+        }
+
+        NodeData data;
+
+        if (type == static_cast<std::uint8_t>(BINARY_DATA_TYPE::INT))
+        {
+            std::uint32_t zigzag;
+
+            if (const auto error = readVarint(rawData, zigzag); error != NODE_MAPPER_ERROR::NONE)
+            {
+                return error;
+            }
+            data = static_cast<int>(static_cast<std::int32_t>((zigzag >> 1U) ^ (~(zigzag & 1U) + 1U)));
+        }
+        else if (type == static_cast<std::uint8_t>(BINARY_DATA_TYPE::FLOAT))
+        {
+            std::uint32_t value = 0U;
+
+            for (std::uint32_t shift = 0U; shift < 32U; shift += 8U)
+            {
+                std::uint8_t byte;
+
+                if (const auto error = readByte(rawData, byte); error != NODE_MAPPER_ERROR::NONE)
+                {
+                    return error;
+                }
+                value |= static_cast<std::uint32_t>(byte) << shift;
+            }
+            data = std::bit_cast<float>(value);
+        }
+        else if (type == static_cast<std::uint8_t>(BINARY_DATA_TYPE::STRING))
+        {
+            std::string_view value;
+
+            if (const auto error = readString(rawData, value); error != NODE_MAPPER_ERROR::NONE)
+            {
+                return error;
+            }
+            data = std::string { value };
+        }
+        else
+        {
+            return NODE_MAPPER_ERROR::UNKNOWN_TYPE;
+        }
+
+        msg.dataArray.insert_or_assign(std::string { key }, std::move(data));
+    }
+
+    return NODE_MAPPER_ERROR::NONE;
+}
+
+bool isBinary (std::string_view rawData) noexcept
+{
+    return (rawData.empty() != true) && (static_cast<std::uint8_t>(rawData.front()) == binaryMarker);
+}
+
+void skipJsonSpace (std::string_view &json) noexcept
+{
+    std::size_t count = 0U;
+
+    while ((count < std::size(json)) && ((json[count] == ' ') || (json[count] == '\t') || (json[count] == '\n') || (json[count] == '\r')))
+    {
+        ++count;
+    }
+    json.remove_prefix(count);
+
+    return;
+}
+
+NODE_MAPPER_ERROR expectJson (std::string_view &json, char symbol) noexcept
+{
+    skipJsonSpace(json);
+
+    if (json.empty() == true)
+    {
+        return NODE_MAPPER_ERROR::UNEXPECTED_END;
+    }
+
+    if (json.front() != symbol)
+    {
+        return NODE_MAPPER_ERROR::UNEXPECTED_CHARACTER;
+    }
+    json.remove_prefix(1U);
+
+    return NODE_MAPPER_ERROR::NONE;
+}
+
+// The value is the raw content between the quotes, escapes are left as they are
+NODE_MAPPER_ERROR readJsonString (std::string_view &json, std::string_view &value, bool &isEscaped) noexcept
+{
+    if (json.empty() == true)
+    {
+        return NODE_MAPPER_ERROR::UNEXPECTED_END;
+    }
+
+    if (json.front() != '"')
+    {
+        return NODE_MAPPER_ERROR::UNEXPECTED_CHARACTER;
+    }
+
+    isEscaped = false;
+
+    for (std::size_t i = 1U; i < std::size(json); ++i)
+    {
+        const char symbol = json[i];
+
+        if (symbol == '"')
+        {
+            value = json.substr(1U, i - 1U);
+            json.remove_prefix(i + 1U);
+
+            return NODE_MAPPER_ERROR::NONE;
+        }
+
+        if (symbol == '\\')
+        {
+            isEscaped = true;
+            ++i;
+        }
+        else if (static_cast<unsigned char>(symbol) < 0x20U)
+        {
+            return NODE_MAPPER_ERROR::INVALID_STRING;
+        }
+    }
+
+    return NODE_MAPPER_ERROR::UNEXPECTED_END;
+}
+
+// Integers out of the int range are kept as floats
+NODE_MAPPER_ERROR readJsonNumber (std::string_view &json, NodeData &value)
+{
+    std::size_t size = 0U;
+    bool isInteger = true;
+
+    while (size < std::size(json))
+    {
+        const char symbol = json[size];
+
+        if ((symbol == '.') || (symbol == 'e') || (symbol == 'E') || (symbol == '+'))
+        {
+            isInteger = false;
+        }
+        else if (((symbol < '0') || (symbol > '9')) && (symbol != '-'))
+        {
+            break;
+        }
+        ++size;
+    }
+
+    if (size == 0U)
+    {
+        return (json.empty() == true) ? NODE_MAPPER_ERROR::UNEXPECTED_END : NODE_MAPPER_ERROR::UNEXPECTED_CHARACTER;
+    }
+
+    const char *begin   = json.data();
+    const char *end     = json.data() + size;
+
+    if (isInteger == true)
+    {
+        int number;
+        const auto [ptr, error] = std::from_chars(begin, end, number);
+
+        if ((error == std::errc {}) && (ptr == end))
+        {
+            value = number;
+            json.remove_prefix(size);
+
+            return NODE_MAPPER_ERROR::NONE;
+        }
+
+        if (error != std::errc::result_out_of_range)
+        {
+            return NODE_MAPPER_ERROR::INVALID_NUMBER;
+        }
+    }
+
+    float number;
+    const auto [ptr, error] = std::from_chars(begin, end, number);
+
+    if ((error != std::errc {}) || (ptr != end))
+    {
+        return NODE_MAPPER_ERROR::INVALID_NUMBER;
+    }
+
+    value = number;
+    json.remove_prefix(size);
+
+    return NODE_MAPPER_ERROR::NONE;
+}
+
+// Fractions and exponents are scanned too, so they are reported as invalid integers
+NODE_MAPPER_ERROR readJsonInt (std::string_view &json, int &value) noexcept
+{
+    std::size_t size = 0U;
+
+    while ((size < std::size(json)) && (std::string_view { "0123456789-+.eE" }.find(json[size]) != std::string_view::npos))
+    {
+        ++size;
+    }
+
+    if (size == 0U)
+    {
+        return (json.empty() == true) ? NODE_MAPPER_ERROR::UNEXPECTED_END : NODE_MAPPER_ERROR::UNEXPECTED_CHARACTER;
+    }
+
+    const auto [ptr, error] = std::from_chars(json.data(), json.data() + size, value);
+
+    if ((error != std::errc {}) || (ptr != json.data() + size))
+    {
+        return NODE_MAPPER_ERROR::INVALID_NUMBER;
+    }
+    json.remove_prefix(size);
+
+    return NODE_MAPPER_ERROR::NONE;
+}
+
+template <typename IdArray>
+NODE_MAPPER_ERROR readJsonIdArray (std::string_view &json, IdArray &idArray)
+{
+    if (const auto error = expectJson(json, '['); error != NODE_MAPPER_ERROR::NONE)
+    {
+        return error;
+    }
+
+    skipJsonSpace(json);
+
+    if ((json.empty() != true) && (json.front() == ']'))
+    {
+        json.remove_prefix(1U);
+
+        return NODE_MAPPER_ERROR::NONE;
+    }
+
+    while (true)
+    {
+        skipJsonSpace(json);
+
+        int id;
+
+        if (const auto error = readJsonInt(json, id); error != NODE_MAPPER_ERROR::NONE)
+        {
+            return error;
+        }
+        idArray.emplace(static_cast<typename IdArray::value_type>(id));
+
+        skipJsonSpace(json);
+
+        if (json.empty() == true)
+        {
+            return NODE_MAPPER_ERROR::UNEXPECTED_END;
+        }
+
+        const char symbol = json.front();
+        json.remove_prefix(1U);
+
+        if (symbol == ']')
+        {
+            return NODE_MAPPER_ERROR::NONE;
+        }
+
+        if (symbol != ',')
+        {
+            return NODE_MAPPER_ERROR::UNEXPECTED_CHARACTER;
+        }
+    }
+}
+
+// Nested values are skipped and stored as empty strings,
+// literals are stored as strings, as the property tree parser did
+NODE_MAPPER_ERROR readJsonData (std::string_view &json, NodeDataArray &dataArray)
+{
+    if (const auto error = expectJson(json, '{'); error != NODE_MAPPER_ERROR::NONE)
+    {
+        return error;
+    }
+
+    skipJsonSpace(json);
+
+    if ((json.empty() != true) && (json.front() == '}'))
+    {
+        json.remove_prefix(1U);
+
+        return NODE_MAPPER_ERROR::NONE;
+    }
+
+    while (true)
+    {
+        skipJsonSpace(json);
+
+        std::string_view rawKey;
+        bool isKeyEscaped;
+
+        if (const auto error = readJsonString(json, rawKey, isKeyEscaped); error != NODE_MAPPER_ERROR::NONE)
+        {
+            return error;
+        }
+
+        if (const auto error = expectJson(json, ':'); error != NODE_MAPPER_ERROR::NONE)
+        {
+            return error;
+        }
+
+        skipJsonSpace(json);
+
+        if (json.empty() == true)
+        {
+            return NODE_MAPPER_ERROR::UNEXPECTED_END;
+        }
+
+        NodeData data;
+        const char symbol = json.front();
+
+        if (symbol == '"')
+        {
+            std::string_view rawValue;
+            bool isValueEscaped;
+
+            if (const auto error = readJsonString(json, rawValue, isValueEscaped); error != NODE_MAPPER_ERROR::NONE)
+            {
+                return error;
+            }
+
+            std::string value;
+
+            if (const auto error = unescapeJsonString(rawValue, value); error != NODE_MAPPER_ERROR::NONE)
+            {
+                return error;
+            }
+            data = std::move(value);
+        }
+        else if (((symbol >= '0') && (symbol <= '9')) || (symbol == '-'))
+        {
+            if (const auto error = readJsonNumber(json, data); error != NODE_MAPPER_ERROR::NONE)
+            {
+                return error;
+            }
+        }
+        else
+        {
+            const std::string_view begin = json;
+
+            if (const auto error = skipJsonValue(json); error != NODE_MAPPER_ERROR::NONE)
+            {
+                return error;
+            }
+
+            if ((symbol != '{') && (symbol != '['))
+            {
+                data = std::string { begin.substr(0U, std::size(begin) - std::size(json)) };
+            }
+            else
+            {
+                data = std::string {};
+            }
+        }
+
+        std::string key;
+
+        if (isKeyEscaped == true)
+        {
+            if (const auto error = unescapeJsonString(rawKey, key); error != NODE_MAPPER_ERROR::NONE)
+            {
+                return error;
+            }
+        }
+        else
+        {
+            key = rawKey;
+        }
+
+        dataArray.insert_or_assign(std::move(key), std::move(data));
+
+        skipJsonSpace(json);
+
+        if (json.empty() == true)
+        {
+            return NODE_MAPPER_ERROR::UNEXPECTED_END;
+        }
+
+        const char delimiter = json.front();
+        json.remove_prefix(1U);
+
+        if (delimiter == '}')
+        {
+            return NODE_MAPPER_ERROR::NONE;
+        }
+
+        if (delimiter != ',')
+        {
+            return NODE_MAPPER_ERROR::UNEXPECTED_CHARACTER;
+        }
+    }
+}
+
+// Skips any value without checking its grammar in depth, only the nesting and the strings are tracked
+NODE_MAPPER_ERROR skipJsonValue (std::string_view &json) noexcept
+{
+    std::size_t depth = 0U;
+
+    if (json.empty() == true)
+    {
+        return NODE_MAPPER_ERROR::UNEXPECTED_END;
+    }
+
+    if ((json.front() == ',') || (json.front() == '}') || (json.front() == ']'))
+    {
+        return NODE_MAPPER_ERROR::UNEXPECTED_CHARACTER;
+    }
+
+    while (json.empty() != true)
+    {
+        const char symbol = json.front();
+
+        if (symbol == '"')
+        {
+            std::string_view value;
+            bool isEscaped;
+
+            if (const auto error = readJsonString(json, value, isEscaped); error != NODE_MAPPER_ERROR::NONE)
+            {
+                return error;
+            }
+        }
+        else if ((symbol == '{') || (symbol == '['))
+        {
+            if (++depth > maxJsonDepth)
+            {
+                return NODE_MAPPER_ERROR::TOO_DEEP;
+            }
+            json.remove_prefix(1U);
+        }
+        else if ((symbol == '}') || (symbol == ']'))
+        {
+            if (depth == 0U)
+            {
+                return NODE_MAPPER_ERROR::NONE;
+            }
+            --depth;
+            json.remove_prefix(1U);
+        }
+        else if ((symbol == ',') && (depth == 0U))
+        {
+            return NODE_MAPPER_ERROR::NONE;
+        }
+        else
+        {
+            json.remove_prefix(1U);
+        }
+
+        if (depth == 0U)
+        {
+            skipJsonSpace(json);
+
+            if ((json.empty() != true) && ((json.front() == ',') || (json.front() == '}') || (json.front() == ']')))
+            {
+                return NODE_MAPPER_ERROR::NONE;
+            }
+        }
+    }
+
+    return NODE_MAPPER_ERROR::UNEXPECTED_END;
+}
+
+NODE_MAPPER_ERROR unescapeJsonString (std::string_view value, std::string &result)
+{
+    result.clear();
+    result.reserve(std::size(value));
+
+    for (std::size_t i = 0U; i < std::size(value); ++i)
+    {
+        const char symbol = value[i];
+
+        if (symbol != '\\')
+        {
+            result.push_back(symbol);
+
+            continue;
+        }
+
+        if (++i == std::size(value))
+        {
+            return NODE_MAPPER_ERROR::INVALID_STRING;
+        }
+
+        switch (value[i])
+        {
+            case '"' :  result.push_back('"');  break;
+            case '\\' : result.push_back('\\'); break;
+            case '/' :  result.push_back('/');  break;
+            case 'b' :  result.push_back('\b'); break;
+            case 'f' :  result.push_back('\f'); break;
+            case 'n' :  result.push_back('\n'); break;
+            case 'r' :  result.push_back('\r'); break;
+            case 't' :  result.push_back('\t'); break;
+
+            case 'u' :
+            {
+                std::uint32_t codePoint = 0U;
+
+                for (std::size_t unit = 0U; unit < 2U; ++unit)
+                {
+                    std::uint16_t code;
+
+                    if (i + 4U >= std::size(value))
+                    {
+                        return NODE_MAPPER_ERROR::INVALID_STRING;
+                    }
+
+                    const auto [ptr, error] = std::from_chars(value.data() + i + 1U, value.data() + i + 5U, code, 16);
+
+                    if ((error != std::errc {}) || (ptr != value.data() + i + 5U))
+                    {
+                        return NODE_MAPPER_ERROR::INVALID_STRING;
+                    }
+                    i += 4U;
+
+                    if (unit == 0U)
+                    {
+                        codePoint = code;
+
+                        if ((code < 0xD800U) || (code > 0xDBFFU))
+                        {
+                            break;
+                        }
+
+                        // High surrogate, the low one has to follow
+                        if ((i + 2U >= std::size(value)) || (value[i + 1U] != '\\') || (value[i + 2U] != 'u'))
+                        {
+                            return NODE_MAPPER_ERROR::INVALID_STRING;
+                        }
+                        i += 2U;
+                    }
+                    else
+                    {
+                        if ((code < 0xDC00U) || (code > 0xDFFFU))
+                        {
+                            return NODE_MAPPER_ERROR::INVALID_STRING;
+                        }
+                        codePoint = 0x10000U + ((codePoint - 0xD800U) << 10U) + (code - 0xDC00U);
+                    }
+                }
+
+                if (codePoint < 0x80U)
+                {
+                    result.push_back(static_cast<char>(codePoint));
+                }
+                else if (codePoint < 0x800U)
+                {
+                    result.push_back(static_cast<char>(0xC0U | (codePoint >> 6U)));
+                    result.push_back(static_cast<char>(0x80U | (codePoint & 0x3FU)));
+                }
+                else if (codePoint < 0x10000U)
+                {
+                    result.push_back(static_cast<char>(0xE0U | (codePoint >> 12U)));
+                    result.push_back(static_cast<char>(0x80U | ((codePoint >> 6U) & 0x3FU)));
+                    result.push_back(static_cast<char>(0x80U | (codePoint & 0x3FU)));
+                }
+                else
+                {
+                    result.push_back(static_cast<char>(0xF0U | (codePoint >> 18U)));
+                    result.push_back(static_cast<char>(0x80U | ((codePoint >> 12U) & 0x3FU)));
+                    result.push_back(static_cast<char>(0x80U | ((codePoint >> 6U) & 0x3FU)));
+                    result.push_back(static_cast<char>(0x80U | (codePoint & 0x3FU)));
+                }
+
+                break;
+            }
+
+            default :
+                return NODE_MAPPER_ERROR::INVALID_STRING;
+        }
+    }
+
+    return NODE_MAPPER_ERROR::NONE;
+}
+
+void writeVarint (std::string &rawData, std::uint32_t value)
+{
+    while (value >= 0x80U)
+    {
+        rawData.push_back(static_cast<char>((value & 0x7FU) | 0x80U));
+        value >>= 7U;
+    }
+    rawData.push_back(static_cast<char>(value));
+
+    return;
+}
+
+void writeString (std::string &rawData, std::string_view value)
+{
+    writeVarint(rawData, static_cast<std::uint32_t>(std::size(value)));
+    rawData.append(value);
+
+    return;
+}
+
+NODE_MAPPER_ERROR readVarint (std::string_view &rawData, std::uint32_t &value) noexcept
+{
+    value = 0U;
+
+    for (std::uint32_t shift = 0U; shift < 35U; shift += 7U)
+    {
+        std::uint8_t byte;
+
+        if (const auto error = readByte(rawData, byte); error != NODE_MAPPER_ERROR::NONE)
+        {
+            return error;
+        }
+        value |= static_cast<std::uint32_t>(byte & 0x7FU) << shift;
+
+        if ((byte & 0x80U) == 0U)
+        {
+            return NODE_MAPPER_ERROR::NONE;
+        }
+    }
+
+    return NODE_MAPPER_ERROR::INVALID_NUMBER;
+}
+
+NODE_MAPPER_ERROR readByte (std::string_view &rawData, std::uint8_t &value) noexcept
+{
+    if (rawData.empty() == true)
+    {
+        return NODE_MAPPER_ERROR::UNEXPECTED_END;
+    }
+
+    value = static_cast<std::uint8_t>(rawData.front());
+    rawData.remove_prefix(1U);
+
+    return NODE_MAPPER_ERROR::NONE;
+}
+
+NODE_MAPPER_ERROR readString (std::string_view &rawData, std::string_view &value) noexcept
+{
+    std::uint32_t size;
+
+    if (const auto error = readVarint(rawData, size); error != NODE_MAPPER_ERROR::NONE)
+    {
+        return error;
+    }
+
+    if (size > std::size(rawData))
+    {
+        return NODE_MAPPER_ERROR::UNEXPECTED_END;
+    }
+
+    value = rawData.substr(0U, size);
+    rawData.remove_prefix(size);
+
+    return NODE_MAPPER_ERROR::NONE;
 }
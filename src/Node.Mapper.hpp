@@ -6,10 +6,39 @@
 #ifndef NODE_MAPPER_H_
 #define NODE_MAPPER_H_
 
+#include <string_view>
+
 #include "Node.Type.hpp"
 
-std::string serialize (const NodeMsg &msg);
-NodeMsgHeader deserializeHeader (const std::string &rawData);
-NodeMsg deserializeMessage (const std::string &rawData);
+enum class NODE_MAPPER_ERROR : std::uint8_t
+{
+    NONE = 0U,
+    UNEXPECTED_END,
+    UNEXPECTED_CHARACTER,
+    INVALID_NUMBER,
+    INVALID_STRING,
+    MISSING_FIELD,
+    TOO_DEEP,
+    UNKNOWN_KEY,
+    UNKNOWN_TYPE,
+    UNKNOWN_COMMAND
+};
+
+// The codec of the raw data is detected by its first byte,
+// the output is valid only if no error is returned.
+// The header and the route (header and command) are read from the front of the message only :
+// the scan stops at their last field, so its cost does not depend on the payload, and the payload is not validated.
+// The route command is raw, as it may be the subscription command, toNodeCommand () checks it against the node command list.
+std::string serialize (const NodeMsg &msg, NODE_CODEC codec);
+NODE_MAPPER_ERROR deserializeHeader (std::string_view rawData, NodeMsgHeader &header);
+NODE_MAPPER_ERROR deserializeRoute (std::string_view rawData, NodeMsgHeader &header, std::uint32_t &cmdID);
+NODE_MAPPER_ERROR deserializeMessage (std::string_view rawData, NodeMsg &msg);
+
+// The subscription is routed as a message with the subscription command and no destination
+std::string serializeSubscription (const NodeSubscription &subscription, NODE_CODEC codec);
+NODE_MAPPER_ERROR deserializeSubscription (std::string_view rawData, NodeSubscription &subscription);
+
+NODE_MAPPER_ERROR toNodeCommand (std::uint32_t command, node_command_id_t &cmdID) noexcept;
+const char* toString (NODE_MAPPER_ERROR error) noexcept;
 
 #endif // NODE_MAPPER_H_
@@ -10,11 +10,24 @@
 #include <string>
 #include <set>
 #include <map>
+#include <cstdint>
 
 #include "node/node.list.h"
 #include "node/node.command.h"
 
+enum class NODE_CODEC : std::uint8_t
+{
+    JSON = 0U,
+    BINARY
+};
+
+// Command to the server itself, out of the node command list :
+// no destination, the message carries a subscription instead of the data.
+// It is never a node_command_id_t value, the raw command is compared instead
+constexpr std::uint32_t NODE_SUBSCRIBE_CMD_ID = 0x100U;
+
 using NodeIdArray = std::set<node_id_t>;
+using NodeCommandArray = std::set<node_command_id_t>;
 using NodeData = std::variant<int, float, std::string>;
 using NodeDataArray = std::map<std::string, NodeData>;
 
@@ -33,4 +46,10 @@ struct NodeMsg
     NodeDataArray dataArray;
 };
 
+struct NodeSubscription
+{
+    node_id_t source;
+    NodeCommandArray cmdArray;  // Broadcast commands the source node consumes, empty to get every broadcast again
+};
+
 #endif // NODE_TYPE_H_
@@ -24,9 +24,9 @@ Node::Node (Node::Config config, boost::asio::io_context &context)
 Node::~Node () = default;
 
 
-void Node::addRawMessage (std::string message)
+void Node::addRawMessage (std::string_view message)
 {
-    auto asyncCallback = std::bind(&Node::processRawMessage, this, std::move(message));
+    auto asyncCallback = std::bind(&Node::processRawMessage, this, std::string { message });
     boost::asio::post(this->ioContext, asyncCallback);
 
     return;
@@ -40,17 +40,29 @@ void Node::addMessage (NodeMsg message)
     return;
 }
 
+// The node still receives the messages addressed to it directly,
+// the subscription filters the broadcast ones only
+void Node::subscribe (NodeCommandArray cmdArray)
+{
+    cmdArray.insert(REQUEST_VERSION);
+
+    NodeSubscription subscription;
+    subscription.source     = this->config.id;
+    subscription.cmdArray   = std::move(cmdArray);
+
+    auto asyncCallback = std::bind(&Node::processSubscription, this, std::move(subscription));
+    boost::asio::post(this->ioContext, asyncCallback);
+
+    return;
+}
+
 void Node::processRawMessage (std::string message)
 {
     NodeMsg nodeMsg;
 
-    try
-    {
-        nodeMsg = deserializeMessage(message);
-    }
-    catch (const std::exception &exp)
+    if (const auto error = deserializeMessage(message, nodeMsg); error != NODE_MAPPER_ERROR::NONE)
     {
-        BOOST_LOG_TRIVIAL(error) << "Node : error = " << exp.what();
+        BOOST_LOG_TRIVIAL(error) << "Node : error = " << toString(error);
 
         return;
     }
@@ -81,7 +93,19 @@ void Node::processRawMessage (std::string message)
 
 void Node::processMessage (NodeMsg message)
 {
-    std::string rawMsg = serialize(message);
+    std::string rawMsg = serialize(message, this->config.codec);
+
+    if (this->config.processRawMessageCallback != nullptr)
+    {
+        this->config.processRawMessageCallback(std::move(rawMsg));
+    }
+
+    return;
+}
+
+void Node::processSubscription (NodeSubscription subscription)
+{
+    std::string rawMsg = serializeSubscription(subscription, this->config.codec);
 
     if (this->config.processRawMessageCallback != nullptr)
     {
@@ -6,6 +6,8 @@
 #ifndef NODE_H_
 #define NODE_H_
 
+#include <string_view>
+
 #include <boost/asio/io_context.hpp>
 
 #include "Node.Type.hpp"
@@ -16,7 +18,8 @@ class Node
         struct Config
         {
             node_id_t id;
-            
+            NODE_CODEC codec;   // Codec of the sent messages, received ones are detected
+
             std::function<void(std::string)> processRawMessageCallback;
             std::function<void(NodeMsg)> processMessageCallback;
         };
@@ -30,12 +33,14 @@ class Node
         ~Node ();
 
     public:
-        void addRawMessage (std::string message);
+        void addRawMessage (std::string_view message);
         void addMessage (NodeMsg message);
+        void subscribe (NodeCommandArray cmdArray);
 
     private:
         void processRawMessage (std::string message);
         void processMessage (NodeMsg message);
+        void processSubscription (NodeSubscription subscription);
 
     private:
         Config config;
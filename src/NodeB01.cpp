@@ -232,7 +232,7 @@ void NodeB01::processRemoteButton (REMOTE_CONTROL_BUTTON button, int64_t timeMS)
         outMsg.cmdID = SET_MODE;
         outMsg.dataArray.emplace("value_id", static_cast<int>(SILENCE_MODE));
 
-        this->outMsgArray.push_back(std::move(outMsg));
+        this->addMessage(std::move(outMsg));
     }
 
     // Set GUARD mode
@@ -250,7 +250,7 @@ void NodeB01::processRemoteButton (REMOTE_CONTROL_BUTTON button, int64_t timeMS)
         outMsg.cmdID = SET_MODE;
         outMsg.dataArray.emplace("value_id", static_cast<int>(GUARD_MODE));
 
-        this->outMsgArray.push_back(std::move(outMsg));
+        this->addMessage(std::move(outMsg));
     }
 
     // Set ALARM mode
@@ -265,7 +265,7 @@ void NodeB01::processRemoteButton (REMOTE_CONTROL_BUTTON button, int64_t timeMS)
         outMsg.cmdID = SET_MODE;
         outMsg.dataArray.emplace("value_id", static_cast<int>(ALARM_MODE));
 
-        this->outMsgArray.push_back(std::move(outMsg));
+        this->addMessage(std::move(outMsg));
     }
 
     // Disable intrusion
@@ -281,7 +281,7 @@ void NodeB01::processRemoteButton (REMOTE_CONTROL_BUTTON button, int64_t timeMS)
         outMsg.cmdID = SET_INTRUSION;
         outMsg.dataArray.emplace("value_id", static_cast<int>(INTRUSION_OFF));
 
-        this->outMsgArray.push_back(std::move(outMsg));
+        this->addMessage(std::move(outMsg));
     }
 
     // Enable light
@@ -296,7 +296,7 @@ void NodeB01::processRemoteButton (REMOTE_CONTROL_BUTTON button, int64_t timeMS)
             outMsg.cmdID = SET_LIGHT;
             outMsg.dataArray.emplace("value_id", static_cast<int>(LIGHT_ON));
 
-            this->outMsgArray.push_back(std::move(outMsg));
+            this->addMessage(std::move(outMsg));
         }
 
         if (this->mode == SILENCE_MODE)
@@ -347,7 +347,7 @@ void NodeB01::processRemoteButton (REMOTE_CONTROL_BUTTON button, int64_t timeMS)
         outMsg.cmdID = SET_WARNING;
         outMsg.dataArray.emplace("value_id", static_cast<int>(warning_id));
 
-        this->outMsgArray.push_back(std::move(outMsg));
+        this->addMessage(std::move(outMsg));
     }
 
     return;
@@ -385,7 +385,7 @@ void NodeB01::processDoorMovement (int64_t timeMS)
             outMsg.cmdID = SET_LIGHT;
             outMsg.dataArray.emplace("value_id", static_cast<int>(LIGHT_ON));
 
-            this->outMsgArray.push_back(std::move(outMsg));
+            this->addMessage(std::move(outMsg));
         }
     }
     return;
@@ -443,7 +443,7 @@ void NodeB01::processSmoke (PeriodicSmokeSensorData data)
             outMsg.cmdID = SET_MODE;
             outMsg.dataArray.emplace("value_id", static_cast<int>(ALARM_MODE));
 
-            this->outMsgArray.push_back(std::move(outMsg));
+            this->addMessage(std::move(outMsg));
         }
     }
 
@@ -463,7 +463,7 @@ void NodeB01::processSmoke (PeriodicSmokeSensorData data)
             outMsg.cmdID = SET_MODE;
             outMsg.dataArray.emplace("value_id", static_cast<int>(SILENCE_MODE));
 
-            this->outMsgArray.push_back(std::move(outMsg));
+            this->addMessage(std::move(outMsg));
         }
     }
 
@@ -553,13 +553,31 @@ void NodeB01::processMessage (const NodeMsg &inMsg, int64_t timeMS)
 
 NodeB01::MessageContainer NodeB01::extractMessages ()
 {
-    auto msgArray = this->outMsgArray;
-
-    this->outMsgArray.clear();
+    MessageContainer msgArray;
+    msgArray.swap(this->outMsgArray);
 
     return msgArray;
 }
 
+// A pending message with the same command and destinations is overwritten by the newer one,
+// so the outbox holds at most one message per key and keeps the order of the first ones
+void NodeB01::addMessage (NodeMsg msg)
+{
+    for (auto itr = std::begin(this->outMsgArray); itr != std::end(this->outMsgArray); ++itr)
+    {
+        if ((itr->cmdID == msg.cmdID) && (itr->header.destArray == msg.header.destArray))
+        {
+            *itr = std::move(msg);
+
+            return;
+        }
+    }
+
+    this->outMsgArray.push_back(std::move(msg));
+
+    return;
+}
+
 void NodeB01::addPeriodicMessages (int64_t timeMS)
 {
     constexpr int64_t MESSAGE_PERIOD_MS = NodeB01::MESSAGE_PERIOD_MIN * 60U * 1000U;
@@ -589,7 +607,7 @@ void NodeB01::addPeriodicMessages (int64_t timeMS)
             outMsg.cmdID = SET_WARNING;
             outMsg.dataArray.emplace("value_id", static_cast<int>(warning_id));
 
-            this->outMsgArray.push_back(std::move(outMsg));
+            this->addMessage(std::move(outMsg));
         }
 
         {
@@ -600,7 +618,7 @@ void NodeB01::addPeriodicMessages (int64_t timeMS)
             outMsg.cmdID = SET_MODE;
             outMsg.dataArray.emplace("value_id", static_cast<int>(this->mode));
 
-            this->outMsgArray.push_back(std::move(outMsg));
+            this->addMessage(std::move(outMsg));
         }
     }
     return;
@@ -628,6 +646,12 @@ node_id_t NodeB01::getId () const noexcept
     return this->id;
 }
 
+// Commands handled by processMessage ()
+NodeCommandArray NodeB01::getSubscription () const
+{
+    return NodeCommandArray { SET_INTRUSION, SET_LIGHT, UPDATE_TEMPERATURE, UPDATE_DOOR_STATE };
+}
+
 
 PeriodicHumiditySensorData NodeB01::getHumidityData () const noexcept
 {
@@ -84,6 +84,7 @@ class NodeB01
         void setConfig (Config config);
         Config getConfig () const;
         node_id_t getId () const noexcept;
+        NodeCommandArray getSubscription () const;
 
     public:
         PeriodicHumiditySensorData getHumidityData () const noexcept;
@@ -96,6 +97,7 @@ class NodeB01
     private:
         void updateTime (int64_t timeMS);
         void addPeriodicMessages (int64_t timeMS);
+        void addMessage (NodeMsg msg);
 
     private:
         Config config;
@@ -121,7 +123,7 @@ class NodeB01
         PeriodicHumiditySensorData humidityDataB02;
 
     private:
-        MessageContainer outMsgArray;
+        MessageContainer outMsgArray;   // Coalesced by command and destinations
 };
 
 #endif // NODE_B01_H_
@@ -32,10 +32,16 @@ OneShotHdmiDisplayB01::OneShotHdmiDisplayB01 (OneShotHdmiDisplayB01::Config conf
 
     this->display = std::make_unique<HdmiDisplay>();
 
+    // Decoded once, the repaints do not touch the files
+    this->display->loadImage(this->config.imageDirectory.string() + "/smile_green.png");
+    this->display->loadImage(this->config.imageDirectory.string() + "/smile_orange.png");
+    this->display->loadImage(this->config.imageDirectory.string() + "/smile_red.png");
+
     this->shiftX = 0.0;
 
     GpioOut::Config gpioOutConfig;
-    gpioOutConfig.gpio = this->config.powerGpio;
+    gpioOutConfig.gpio     = this->config.powerGpio;
+    gpioOutConfig.backend  = GpioOut::BACKEND::CHARDEV;
 
     this->powerGpio = std::make_unique<GpioOut>(gpioOutConfig);
 
@@ -158,7 +164,7 @@ boost::asio::awaitable<void> OneShotHdmiDisplayB01::showAsync (OneShotHdmiDispla
 
 void OneShotHdmiDisplayB01::drawData (OneShotHdmiDisplayDataB01 data)
 {
-    this->display->enableFrameBuffer();
+    const auto frame = this->display->beginFrame();
 
     this->display->fillBackground(HdmiDisplay::COLOR::BLACK);
 
@@ -494,7 +500,7 @@ void OneShotHdmiDisplayB01::drawData (OneShotHdmiDisplayDataB01 data)
             file = this->config.imageDirectory.string() + "/smile_red.png";
         }
 
-        if (std::filesystem::exists(file) == true)
+        if (this->display->loadImage(file.string()) == true)
         {
             HdmiDisplay::Image image;
             image.x = this->shiftX + 580.0;
@@ -505,7 +511,7 @@ void OneShotHdmiDisplayB01::drawData (OneShotHdmiDisplayDataB01 data)
         }
     }
 
-    this->display->disableFrameBuffer();
+    this->display->endFrame();
 
     if (this->shiftX > 119.0)
     {
@@ -557,11 +563,9 @@ void OneShotHdmiDisplayB01::playAudio (std::filesystem::path file) const
 
 void OneShotHdmiDisplayB01::cleanDisplay ()
 {
-    this->display->enableFrameBuffer();
-
+    const auto frame = this->display->beginFrame();
     this->display->fillBackground(HdmiDisplay::COLOR::BLACK);
-
-    this->display->disableFrameBuffer();
+    this->display->endFrame();
 
     return;
 }
@@ -570,6 +574,9 @@ void OneShotHdmiDisplayB01::enablePower ()
 {
     this->powerGpio->setHigh();
 
+    // The display may come back in another mode
+    this->display->invalidateFrameBuffer();
+
     return;
 }
 
@@ -21,7 +21,8 @@ OneShotLight::OneShotLight (OneShotLight::Config config, boost::asio::io_context
     this->isPowerEnabled = false;
 
     GpioOut::Config gpioOutConfig;
-    gpioOutConfig.gpio = this->config.powerGpio;
+    gpioOutConfig.gpio     = this->config.powerGpio;
+    gpioOutConfig.backend  = GpioOut::BACKEND::CHARDEV;
 
     this->powerGpio = std::make_unique<GpioOut>(gpioOutConfig);
 
@@ -22,7 +22,8 @@ PeriodicDustSensor::PeriodicDustSensor (PeriodicDustSensor::Config config, boost
     this->sensor = std::make_unique<DustSensor>();
 
     GpioOut::Config gpioOutConfig;
-    gpioOutConfig.gpio = this->config.powerGpio;
+    gpioOutConfig.gpio     = this->config.powerGpio;
+    gpioOutConfig.backend  = GpioOut::BACKEND::CHARDEV;
 
     this->powerGpio = std::make_unique<GpioOut>(gpioOutConfig);
 
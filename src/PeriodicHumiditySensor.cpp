@@ -22,7 +22,8 @@ PeriodicHumiditySensor::PeriodicHumiditySensor (PeriodicHumiditySensor::Config c
     this->sensor = std::make_unique<HumiditySensor>();
 
     GpioOut::Config gpioOutConfig;
-    gpioOutConfig.gpio = this->config.powerGpio;
+    gpioOutConfig.gpio     = this->config.powerGpio;
+    gpioOutConfig.backend  = GpioOut::BACKEND::CHARDEV;
 
     this->powerGpio = std::make_unique<GpioOut>(gpioOutConfig);
 
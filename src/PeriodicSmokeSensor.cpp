@@ -6,7 +6,8 @@
 #include "PeriodicSmokeSensor.hpp"
 
 #include <ranges>
-#include <numeric>
+#include <algorithm>
+#include <functional>
 
 #include <boost/asio/co_spawn.hpp>
 #include <boost/asio/detached.hpp>
@@ -22,10 +23,14 @@ PeriodicSmokeSensor::PeriodicSmokeSensor (PeriodicSmokeSensor::Config config, bo
 {
     this->config = config;
 
-    this->sensor = std::make_unique<SmokeSensor>();
+    this->topArray.reserve(this->config.sampleCount / 2U);
+    this->topSum = 0U;
+
+    this->sensor = std::make_unique<SmokeSensor>(this->config.adcCapture);
 
     GpioOut::Config gpioOutConfig;
-    gpioOutConfig.gpio = this->config.powerGpio;
+    gpioOutConfig.gpio     = this->config.powerGpio;
+    gpioOutConfig.backend  = GpioOut::BACKEND::CHARDEV;
 
     this->powerGpio = std::make_unique<GpioOut>(gpioOutConfig);
     
@@ -49,9 +54,6 @@ void PeriodicSmokeSensor::start ()
 
 boost::asio::awaitable<void> PeriodicSmokeSensor::readAsync ()
 {
-    std::vector<std::size_t> adcBuffer;
-    adcBuffer.reserve(this->config.sampleCount);
-
     BOOST_LOG_TRIVIAL(info) << "Smoke sensor : initial warm up";
 
     this->enablePower();
@@ -63,7 +65,7 @@ boost::asio::awaitable<void> PeriodicSmokeSensor::readAsync ()
     {
         try
         {
-            adcBuffer.clear();
+            this->resetData();
 
             BOOST_LOG_TRIVIAL(info) << "Smoke sensor : power on";
 
@@ -79,13 +81,20 @@ boost::asio::awaitable<void> PeriodicSmokeSensor::readAsync ()
                 this->timer.expires_from_now(boost::posix_time::seconds(this->config.sampleTimeS));
                 co_await this->timer.async_wait(boost::asio::use_awaitable);
 
-                const auto adcValue = this->sensor->readAdcValue();
-                adcBuffer.push_back(adcValue);
+                const auto adcValue = co_await this->sensor->readAdcValueAsync();
+                this->addSample(adcValue);
 
                 BOOST_LOG_TRIVIAL(info) << "Smoke sensor : read ADC value = " << adcValue;
+
+                if (this->isAlarmCertain() == true)
+                {
+                    BOOST_LOG_TRIVIAL(info) << "Smoke sensor : early alarm after " << (i + 1U) << " samples";
+
+                    break;
+                }
             }
 
-            const auto data = this->computeData(adcBuffer);
+            const auto data = this->computeData();
 
             BOOST_LOG_TRIVIAL(info) << "Smoke sensor : average ADC value = " << data.adcValue;
 
@@ -124,19 +133,64 @@ void PeriodicSmokeSensor::enablePower ()
     return;
 }
 
-PeriodicSmokeSensorData PeriodicSmokeSensor::computeData (std::vector<std::size_t> &adcBuffer)
+void PeriodicSmokeSensor::resetData ()
+{
+    this->topArray.clear();
+    this->topSum = 0U;
+
+    return;
+}
+
+// The value of a window is the mean of its greatest half, kept up to date on every sample
+void PeriodicSmokeSensor::addSample (std::size_t adcValue)
 {
     const std::size_t sampleHalf = this->config.sampleCount / 2U;
 
-    std::ranges::nth_element(adcBuffer, std::ranges::next(std::begin(adcBuffer), sampleHalf), std::greater<std::size_t>());
+    if (std::size(this->topArray) < sampleHalf)
+    {
+        this->topArray.push_back(adcValue);
+        std::ranges::push_heap(this->topArray, std::greater<std::size_t>());
+
+        this->topSum += adcValue;
+    }
+    else if ((sampleHalf > 0U) && (adcValue > this->topArray.front()))
+    {
+        this->topSum -= this->topArray.front();
+
+        std::ranges::pop_heap(this->topArray, std::greater<std::size_t>());
+        this->topArray.back() = adcValue;
+        std::ranges::push_heap(this->topArray, std::greater<std::size_t>());
+
+        this->topSum += adcValue;
+    }
 
+    return;
+}
+
+// A further sample can only replace a lower one, so the mean of a full top never decreases
+bool PeriodicSmokeSensor::isAlarmCertain () const noexcept
+{
+    const std::size_t sampleHalf = this->config.sampleCount / 2U;
+
+    if ((sampleHalf == 0U) || (std::size(this->topArray) < sampleHalf))
+    {
+        return false;
+    }
+
+    return ((this->topSum / sampleHalf) > this->config.alarmThresholdAdc);
+}
+
+PeriodicSmokeSensorData PeriodicSmokeSensor::computeData () const
+{
     PeriodicSmokeSensorData data;
     data.isValid    = false;
+    data.adcValue   = 0U;
 
-    data.adcValue = std::accumulate(std::cbegin(adcBuffer), std::next(std::cbegin(adcBuffer), sampleHalf), 0U);
-
-    data.adcValue   = data.adcValue / sampleHalf;
-    data.isValid    = true;
+    if (this->topArray.empty() != true)
+    {
+        data.adcValue   = this->topSum / std::size(this->topArray);
+        data.isValid    = true;
+    }
 
     return data;
 }
@@ -11,6 +11,7 @@
 
 #include "PeriodicSmokeSensor.Type.hpp"
 
+class AdcCapture;
 class SmokeSensor;
 class GpioOut;
 
@@ -25,6 +26,9 @@ class PeriodicSmokeSensor
             std::size_t sampleTimeS;
             std::size_t sleepTimeMin;
             std::size_t powerGpio;
+            std::size_t alarmThresholdAdc;  // A window is cut short, once its value is known to exceed it
+
+            std::shared_ptr<AdcCapture> adcCapture;
 
             std::function<void(PeriodicSmokeSensorData)> processCallback;
         };
@@ -45,12 +49,19 @@ class PeriodicSmokeSensor
 
     private:
         void enablePower ();
-        PeriodicSmokeSensorData computeData (std::vector<std::size_t> &adcBuffer);
+        void resetData ();
+        void addSample (std::size_t adcValue);
+        bool isAlarmCertain () const noexcept;
+        PeriodicSmokeSensorData computeData () const;
         void disablePower ();
 
     private:
         Config config;
 
+    private:
+        std::vector<std::size_t> topArray;  // Min-heap of the greatest half of the window samples
+        std::size_t topSum;
+
     private:
         boost::asio::deadline_timer timer;
         std::unique_ptr<SmokeSensor> sensor;
@@ -5,24 +5,21 @@
 
 #include "PhotoResistor.hpp"
 
-#include <fstream>
-#include <filesystem>
+#include "device/AdcCapture.hpp"
 
 
-PhotoResistor::PhotoResistor () = default;
-PhotoResistor::~PhotoResistor () = default;
-
-
-std::size_t PhotoResistor::readAdcValue () const
+PhotoResistor::PhotoResistor (std::shared_ptr<AdcCapture> capture)
 {
-    const std::filesystem::path adcValuePath = "/sys/bus/iio/devices/iio:device0/in_voltage5_raw";
+    this->adcCapture = std::move(capture);
 
-    std::ifstream dataStream;
-    dataStream.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+    return;
+}
+
+PhotoResistor::~PhotoResistor () = default;
 
-    std::size_t adcValue;
-    dataStream.open(adcValuePath, std::ios_base::in);
-    dataStream >> adcValue;
 
-    return adcValue;
+// Average of a block of conversions, a single one without the buffered capture
+boost::asio::awaitable<std::size_t> PhotoResistor::readAdcValueAsync ()
+{
+    co_return co_await this->adcCapture->readAverageAsync(PhotoResistor::ADC_CHANNEL);
 }
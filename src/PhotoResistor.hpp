@@ -6,12 +6,21 @@
 #ifndef PHOTO_RESISTOR_H_
 #define PHOTO_RESISTOR_H_
 
+#include <memory>
+#include <utility>
 #include <cstddef>
 
+#include <boost/asio/awaitable.hpp>
+
+class AdcCapture;
+
 class PhotoResistor
 {
     public:
-        explicit PhotoResistor ();
+        static constexpr std::size_t ADC_CHANNEL = 5U;
+
+    public:
+        explicit PhotoResistor (std::shared_ptr<AdcCapture> capture);
         PhotoResistor (const PhotoResistor&) = delete;
         PhotoResistor& operator= (const PhotoResistor&) = delete;
         PhotoResistor (PhotoResistor&&) = delete;
@@ -19,7 +28,10 @@ class PhotoResistor
         ~PhotoResistor ();
 
     public:
-        std::size_t readAdcValue () const;
+        boost::asio::awaitable<std::size_t> readAdcValueAsync ();
+
+    private:
+        std::shared_ptr<AdcCapture> adcCapture;     // Shared by every ADC user, one read captures all their channels
 };
 
 #endif // PHOTO_RESISTOR_H_
@@ -5,32 +5,116 @@
 
 #include "RemoteControl.hpp"
 
+#include <limits>
+#include <algorithm>
+
 #include "GpioInt.hpp"
 #include "devices/vs1838_control.h"
 
 
+// Perfect hash of the button codes : (code * multiplier) >> (32 - buttonHashBits)
+static constexpr std::size_t buttonHashBits = 6U;
+static constexpr std::size_t buttonHashSize = (1U << buttonHashBits);
+
+struct ButtonEntry
+{
+    std::uint32_t code;
+    REMOTE_CONTROL_BUTTON button;
+};
+
+static constexpr std::array<std::uint32_t, REMOTE_CONTROL_BUTTON::UNKNOWN> buttonCodeArray
+{
+    ZERO_BUTTON_CODE,
+    ONE_BUTTON_CODE,
+    TWO_BUTTON_CODE,
+    THREE_BUTTON_CODE,
+    FOUR_BUTTON_CODE,
+    FIVE_BUTTON_CODE,
+    SIX_BUTTON_CODE,
+    SEVEN_BUTTON_CODE,
+    EIGHT_BUTTON_CODE,
+    NINE_BUTTON_CODE,
+    STAR_BUTTON_CODE,
+    GRID_BUTTON_CODE,
+    UP_BUTTON_CODE,
+    LEFT_BUTTON_CODE,
+    OK_BUTTON_CODE,
+    RIGHT_BUTTON_CODE,
+    DOWN_BUTTON_CODE
+};
+
+static constexpr std::size_t hashButtonCode (std::uint32_t code, std::uint32_t multiplier) noexcept
+{
+    return static_cast<std::size_t>(static_cast<std::uint32_t>(code * multiplier) >> (32U - buttonHashBits));
+}
+
+// The first odd multiplier without collisions, zero if there is none
+static constexpr std::uint32_t findButtonMultiplier () noexcept
+{
+    for (std::uint32_t multiplier = 0x9E3779B1U; multiplier < (0x9E3779B1U + 0x20000U); multiplier += 2U)
+    {
+        std::array<bool, buttonHashSize> usedArray {};
+        bool isPerfect = true;
+
+        for (std::size_t i = 0U; (i < std::size(buttonCodeArray)) && (isPerfect == true); ++i)
+        {
+            const std::size_t index = hashButtonCode(buttonCodeArray[i], multiplier);
+
+            isPerfect = (usedArray[index] != true);
+            usedArray[index] = true;
+        }
+
+        if (isPerfect == true)
+        {
+            return multiplier;
+        }
+    }
+
+    return 0U;
+}
+
+static constexpr std::uint32_t buttonHashMultiplier = findButtonMultiplier();
+
+static_assert(buttonHashMultiplier != 0U, "Button codes must be unique");
+
+static constexpr std::array<ButtonEntry, buttonHashSize> makeButtonTable () noexcept
+{
+    std::array<ButtonEntry, buttonHashSize> table {};
+
+    for (std::size_t i = 0U; i < std::size(table); ++i)
+    {
+        table[i].code   = 0U;
+        table[i].button = REMOTE_CONTROL_BUTTON::UNKNOWN;
+    }
+
+    for (std::size_t i = 0U; i < std::size(buttonCodeArray); ++i)
+    {
+        const std::size_t index = hashButtonCode(buttonCodeArray[i], buttonHashMultiplier);
+
+        table[index].code   = buttonCodeArray[i];
+        table[index].button = static_cast<REMOTE_CONTROL_BUTTON>(i);
+    }
+
+    return table;
+}
+
+static constexpr std::array<ButtonEntry, buttonHashSize> buttonTable = makeButtonTable();
+
+static constexpr REMOTE_CONTROL_BUTTON findButton (std::uint32_t code) noexcept
+{
+    const ButtonEntry &entry = buttonTable[hashButtonCode(code, buttonHashMultiplier)];
+
+    return (entry.code == code) ? entry.button : REMOTE_CONTROL_BUTTON::UNKNOWN;
+}
+
+static_assert(findButton(OK_BUTTON_CODE) == REMOTE_CONTROL_BUTTON::OK);
+static_assert(findButton(DOWN_BUTTON_CODE) == REMOTE_CONTROL_BUTTON::DOWN);
+
+
 RemoteControl::RemoteControl (RemoteControl::Config config, boost::asio::io_context &context)
 {
     this->config = config;
 
-    this->buttonTable[REMOTE_CONTROL_BUTTON::ZERO]  = ZERO_BUTTON_CODE;
-    this->buttonTable[REMOTE_CONTROL_BUTTON::ONE]   = ONE_BUTTON_CODE;
-    this->buttonTable[REMOTE_CONTROL_BUTTON::TWO]   = TWO_BUTTON_CODE;
-    this->buttonTable[REMOTE_CONTROL_BUTTON::THREE] = THREE_BUTTON_CODE;
-    this->buttonTable[REMOTE_CONTROL_BUTTON::FOUR]  = FOUR_BUTTON_CODE;
-    this->buttonTable[REMOTE_CONTROL_BUTTON::FIVE]  = FIVE_BUTTON_CODE;
-    this->buttonTable[REMOTE_CONTROL_BUTTON::SIX]   = SIX_BUTTON_CODE;
-    this->buttonTable[REMOTE_CONTROL_BUTTON::SEVEN] = SEVEN_BUTTON_CODE;
-    this->buttonTable[REMOTE_CONTROL_BUTTON::EIGHT] = EIGHT_BUTTON_CODE;
-    this->buttonTable[REMOTE_CONTROL_BUTTON::NINE]  = NINE_BUTTON_CODE;
-    this->buttonTable[REMOTE_CONTROL_BUTTON::STAR]  = STAR_BUTTON_CODE;
-    this->buttonTable[REMOTE_CONTROL_BUTTON::GRID]  = GRID_BUTTON_CODE;
-    this->buttonTable[REMOTE_CONTROL_BUTTON::UP]    = UP_BUTTON_CODE;
-    this->buttonTable[REMOTE_CONTROL_BUTTON::LEFT]  = LEFT_BUTTON_CODE;
-    this->buttonTable[REMOTE_CONTROL_BUTTON::OK]    = OK_BUTTON_CODE;
-    this->buttonTable[REMOTE_CONTROL_BUTTON::RIGHT] = RIGHT_BUTTON_CODE;
-    this->buttonTable[REMOTE_CONTROL_BUTTON::DOWN]  = DOWN_BUTTON_CODE;
-
     {
         vs1838_control_config_t config;
         config.start_bit    = 13520U;
@@ -46,12 +130,14 @@ RemoteControl::RemoteControl (RemoteControl::Config config, boost::asio::io_cont
         GpioInt::Config config;
         config.gpio                 = this->config.gpio;
         config.edge                 = GpioInt::EDGE::FALLING;
-        config.interruptCallback    = std::bind(&RemoteControl::processSignal, this);
+        config.backend              = GpioInt::BACKEND::CHARDEV;
+        config.batchTimeMS          = RemoteControl::FRAME_TIME_MS;
+        config.interruptCallback    = std::bind(&RemoteControl::processSignal, this, std::placeholders::_1);
 
         this->gpio = std::make_unique<GpioInt>(config, context);
     }
 
-    this->start = boost::posix_time::microsec_clock::local_time();
+    this->startNS = 0U;
 
     return;
 }
@@ -59,16 +145,17 @@ RemoteControl::RemoteControl (RemoteControl::Config config, boost::asio::io_cont
 RemoteControl::~RemoteControl () = default;
 
 
-void RemoteControl::processSignal ()
+// The edge times come from the gpio, so the dispatch latency does not distort the pulse widths.
+// A batch usually holds a whole frame, a frame split between batches is completed by the next one
+void RemoteControl::processSignal (std::span<const std::uint64_t> edgeTimeArray)
 {
-    REMOTE_CONTROL_BUTTON button = REMOTE_CONTROL_BUTTON::UNKNOWN;
-
-    const auto end = boost::posix_time::microsec_clock::local_time();
-    const auto duration = (end - this->start).total_microseconds();
-    this->start = end;
-
+    for (auto itr = std::cbegin(edgeTimeArray); itr != std::cend(edgeTimeArray); ++itr)
     {
-        vs1838_control_process_bit(this->vs1838_control.get(), static_cast<std::uint32_t>(duration));
+        // A long pause must not wrap around into a valid bit width
+        const std::uint64_t durationUS = std::min<std::uint64_t>((*itr - this->startNS) / 1000U, std::numeric_limits<std::uint32_t>::max());
+        this->startNS = *itr;
+
+        vs1838_control_process_bit(this->vs1838_control.get(), static_cast<std::uint32_t>(durationUS));
 
         bool is_frame_ready;
         vs1838_control_is_frame_ready(this->vs1838_control.get(), &is_frame_ready);
@@ -79,15 +166,7 @@ void RemoteControl::processSignal ()
             vs1838_control_get_frame(this->vs1838_control.get(), &button_code);
             vs1838_control_reset_frame(this->vs1838_control.get());
 
-            for (std::size_t i = 0U; i < std::size(this->buttonTable); ++i)
-            {
-                if (this->buttonTable[i] == button_code)
-                {
-                    button = static_cast<REMOTE_CONTROL_BUTTON>(i);
-
-                    break;
-                }
-            }
+            const REMOTE_CONTROL_BUTTON button = findButton(button_code);
 
             if (button != REMOTE_CONTROL_BUTTON::UNKNOWN)
             {
@@ -95,5 +174,6 @@ void RemoteControl::processSignal ()
             }
         }
     }
+
     return;
 }
@@ -6,8 +6,10 @@
 #ifndef REMOTE_CONTROL_H_
 #define REMOTE_CONTROL_H_
 
+#include <span>
+#include <cstdint>
+
 #include <boost/asio/io_context.hpp>
-#include <boost/date_time/posix_time/posix_time_types.hpp>
 
 #include "RemoteControl.Type.hpp"
 
@@ -16,6 +18,10 @@ typedef struct vs1838_control vs1838_control_t;
 
 class RemoteControl
 {
+    public:
+        // NEC frame from the first to the last falling edge : 13.5 ms start + 32 bits of 2.25 ms at most
+        static constexpr std::size_t FRAME_TIME_MS = 90U;
+
     public:
         struct Config
         {
@@ -32,7 +38,7 @@ class RemoteControl
         ~RemoteControl ();
 
     public:
-        void processSignal ();
+        void processSignal (std::span<const std::uint64_t> edgeTimeArray);
 
     private:
         Config config;
@@ -40,8 +46,7 @@ class RemoteControl
     private:
         std::unique_ptr<GpioInt> gpio;
         std::unique_ptr<vs1838_control_t> vs1838_control;
-        boost::posix_time::ptime start;
-        std::array<std::uint32_t, REMOTE_CONTROL_BUTTON::UNKNOWN> buttonTable;
+        std::uint64_t startNS;
 };
 
 #endif // REMOTE_CONTROL_H_
@@ -16,4 +16,11 @@ enum class STATUS_LED_COLOR : std::size_t
     NO_COLOR
 };
 
+enum class STATUS_LED_PATTERN : std::size_t
+{
+    FLASH = 0U, // Short flash every 1.5 s
+    BLINK,      // Half a second on, half a second off
+    SOLID       // Steady light, the brightness sets its duty cycle
+};
+
 #endif // STATUS_LED_TYPE_H_
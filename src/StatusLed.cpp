@@ -7,6 +7,12 @@
 
 #include <fstream>
 #include <filesystem>
+#include <algorithm>
+#include <stdexcept>
+#include <charconv>
+
+#include <fcntl.h>
+#include <unistd.h>
 
 
 #define RED_PATH    "/sys/devices/platform/dmtimer-pwm@5/pwm/pwmchip2"
@@ -16,102 +22,118 @@
 
 StatusLed::StatusLed ()
 {
-    const std::string redPath   = RED_PATH;
-    const std::string bluePath  = BLUE_PATH;
-    const std::string greenPath = GREEN_PATH;
+    std::array<std::string, 3U> pathArray;
+    pathArray[static_cast<std::size_t>(STATUS_LED_COLOR::GREEN)]    = GREEN_PATH;
+    pathArray[static_cast<std::size_t>(STATUS_LED_COLOR::BLUE)]     = BLUE_PATH;
+    pathArray[static_cast<std::size_t>(STATUS_LED_COLOR::RED)]      = RED_PATH;
 
-    const std::string exportPath    = "/export";
-    const std::string periodPath    = "/pwm0/period";
-    const std::string dutyCyclePath = "/pwm0/duty_cycle";
-    const std::string enablePath    = "/pwm0/enable";
-
-    // Try to turn on a timer
-    if (std::filesystem::path redEnablePath = redPath + enablePath; std::filesystem::exists(redEnablePath) != true)
+    for (auto itr = std::begin(this->channelArray); itr != std::end(this->channelArray); ++itr)
     {
-        std::ofstream dataStream;
-        dataStream.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-
-        dataStream.open(redPath + exportPath, std::ios_base::out);
-        dataStream << 0U;
+        itr->enableDescriptor       = (-1);
+        itr->periodDescriptor       = (-1);
+        itr->dutyCycleDescriptor    = (-1);
     }
 
-    if (std::filesystem::path blueEnablePath = bluePath + enablePath; std::filesystem::exists(blueEnablePath) != true)
+    // The destructor does not run for a throwing constructor, so the opened files are closed here
+    try
     {
-        std::ofstream dataStream;
-        dataStream.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-
-        dataStream.open(bluePath + exportPath, std::ios_base::out);
-        dataStream << 0U;
+        this->openChannels(pathArray);
     }
 
-    if (std::filesystem::path greenEnablePath = greenPath + enablePath; std::filesystem::exists(greenEnablePath) != true)
+    catch (...)
     {
-        std::ofstream dataStream;
-        dataStream.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+        this->closeChannels();
 
-        dataStream.open(greenPath + exportPath, std::ios_base::out);
-        dataStream << 0U;
+        throw;
     }
 
-    // Setup period
-    {
-        std::ofstream dataStream;
-        dataStream.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+    this->currentColor = STATUS_LED_COLOR::NO_COLOR;
 
-        dataStream.open(redPath + periodPath, std::ios_base::out);
-        dataStream << StatusLed::periodNS;
-    }
+    return;
+}
 
-    {
-        std::ofstream dataStream;
-        dataStream.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+StatusLed::~StatusLed ()
+{
+    this->closeChannels();
 
-        dataStream.open(bluePath + periodPath, std::ios_base::out);
-        dataStream << StatusLed::periodNS;
-    }
+    return;
+}
 
-    {
-        std::ofstream dataStream;
-        dataStream.exceptions(std::ifstream::failbit | std::ifstream::badbit);
 
-        dataStream.open(greenPath + periodPath, std::ios_base::out);
-        dataStream << StatusLed::periodNS;
-    }
+void StatusLed::openChannels (const std::array<std::string, 3U> &pathArray)
+{
+    const std::string exportPath    = "/export";
+    const std::string periodPath    = "/pwm0/period";
+    const std::string dutyCyclePath = "/pwm0/duty_cycle";
+    const std::string enablePath    = "/pwm0/enable";
 
-    // Setup duty cycle
+    for (std::size_t i = 0U; i < std::size(pathArray); ++i)
     {
-        std::ofstream dataStream;
-        dataStream.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-
-        dataStream.open(redPath + dutyCyclePath, std::ios_base::out);
-        dataStream << StatusLed::dutyCycleNS;
+        // Try to turn on a timer
+        if (std::filesystem::path channelEnablePath = pathArray[i] + enablePath; std::filesystem::exists(channelEnablePath) != true)
+        {
+            std::ofstream dataStream;
+            dataStream.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+
+            dataStream.open(pathArray[i] + exportPath, std::ios_base::out);
+            dataStream << 0U;
+        }
+
+        Channel &channel = this->channelArray[i];
+
+        channel.enableDescriptor    = open((pathArray[i] + enablePath).c_str(), O_WRONLY | O_CLOEXEC);
+        channel.periodDescriptor    = open((pathArray[i] + periodPath).c_str(), O_WRONLY | O_CLOEXEC);
+        channel.dutyCycleDescriptor = open((pathArray[i] + dutyCyclePath).c_str(), O_WRONLY | O_CLOEXEC);
+
+        if ((channel.enableDescriptor < 0) || (channel.periodDescriptor < 0) || (channel.dutyCycleDescriptor < 0))
+        {
+            throw std::runtime_error { "File open error" };
+        }
+
+        // The values left by a previous run are unknown, so everything is written once.
+        // A zero duty cycle first, the kernel rejects a period shorter than the duty cycle
+        this->writeValue(channel.enableDescriptor, 0U);
+        this->writeValue(channel.dutyCycleDescriptor, 0U);
+
+        channel.isEnabled   = false;
+        channel.periodNS    = 0U;
+        channel.dutyCycleNS = 0U;
     }
 
-    {
-        std::ofstream dataStream;
-        dataStream.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+    this->currentPeriodNS       = StatusLed::periodNS;
+    this->currentDutyCycleNS    = StatusLed::dutyCycleNS;
 
-        dataStream.open(bluePath + dutyCyclePath, std::ios_base::out);
-        dataStream << StatusLed::dutyCycleNS;
+    for (auto itr = std::begin(this->channelArray); itr != std::end(this->channelArray); ++itr)
+    {
+        this->setWaveform(*itr);
     }
 
-    {
-        std::ofstream dataStream;
-        dataStream.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+    return;
+}
 
-        dataStream.open(greenPath + dutyCyclePath, std::ios_base::out);
-        dataStream << StatusLed::dutyCycleNS;
+void StatusLed::closeChannels () noexcept
+{
+    for (auto itr = std::cbegin(this->channelArray); itr != std::cend(this->channelArray); ++itr)
+    {
+        if (itr->enableDescriptor >= 0)
+        {
+            close(itr->enableDescriptor);
+        }
+
+        if (itr->periodDescriptor >= 0)
+        {
+            close(itr->periodDescriptor);
+        }
+
+        if (itr->dutyCycleDescriptor >= 0)
+        {
+            close(itr->dutyCycleDescriptor);
+        }
     }
 
-    this->currentColor = STATUS_LED_COLOR::NO_COLOR;
-
-    this->setColor(this->currentColor);
-    
     return;
 }
 
-StatusLed::~StatusLed () = default;
-
 
 void StatusLed::updateColor (STATUS_LED_COLOR color)
 {
@@ -122,68 +144,104 @@ void StatusLed::updateColor (STATUS_LED_COLOR color)
     return;
 }
 
+// The waveform goes to the lit channel only, the others get it when they are lit
+void StatusLed::updatePattern (STATUS_LED_PATTERN pattern, std::size_t brightnessPercent)
+{
+    if (pattern == STATUS_LED_PATTERN::FLASH)
+    {
+        this->currentPeriodNS       = StatusLed::periodNS;
+        this->currentDutyCycleNS    = StatusLed::dutyCycleNS;
+    }
+    else if (pattern == STATUS_LED_PATTERN::BLINK)
+    {
+        this->currentPeriodNS       = StatusLed::blinkPeriodNS;
+        this->currentDutyCycleNS    = StatusLed::blinkDutyCycleNS;
+    }
+    else
+    {
+        this->currentPeriodNS       = StatusLed::solidPeriodNS;
+        this->currentDutyCycleNS    = (StatusLed::solidPeriodNS / 100U) * std::min<std::size_t>(brightnessPercent, 100U);
+    }
+
+    this->setColor(this->currentColor);
+
+    return;
+}
+
 STATUS_LED_COLOR StatusLed::getCurrentColor () const noexcept
 {
     return this->currentColor;
 }
 
-void StatusLed::setColor (STATUS_LED_COLOR color) const
+void StatusLed::setColor (STATUS_LED_COLOR color)
 {
-    const std::string redPath   = RED_PATH;
-    const std::string bluePath  = BLUE_PATH;
-    const std::string greenPath = GREEN_PATH;
-
-    const std::string enablePath = "/pwm0/enable";
-
-    // Disable all pwm
+    // Disable the other pwm
+    for (std::size_t i = 0U; i < std::size(this->channelArray); ++i)
     {
-        std::ofstream dataStream;
-        dataStream.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+        Channel &channel = this->channelArray[i];
 
-        dataStream.open(redPath + enablePath, std::ios_base::out);
-        dataStream << 0U;
+        if ((i != static_cast<std::size_t>(color)) && (channel.isEnabled == true))
+        {
+            this->writeValue(channel.enableDescriptor, 0U);
+            channel.isEnabled = false;
+        }
     }
 
+    // Enable necessary pwm
+    if (color != STATUS_LED_COLOR::NO_COLOR)
     {
-        std::ofstream dataStream;
-        dataStream.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+        Channel &channel = this->channelArray[static_cast<std::size_t>(color)];
 
-        dataStream.open(bluePath + enablePath, std::ios_base::out);
-        dataStream << 0U;
-    }
-
-    {
-        std::ofstream dataStream;
-        dataStream.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+        this->setWaveform(channel);
 
-        dataStream.open(greenPath + enablePath, std::ios_base::out);
-        dataStream << 0U;
+        if (channel.isEnabled != true)
+        {
+            this->writeValue(channel.enableDescriptor, 1U);
+            channel.isEnabled = true;
+        }
     }
 
-    // Enable necessary pwm
-    if (color == STATUS_LED_COLOR::RED)
-    {
-        std::ofstream dataStream;
-        dataStream.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+    return;
+}
 
-        dataStream.open(redPath + enablePath, std::ios_base::out);
-        dataStream << 1U;
+void StatusLed::setWaveform (StatusLed::Channel &channel) const
+{
+    // The duty cycle must never exceed the period, so the order depends on the direction of the change
+    if (this->currentPeriodNS >= channel.dutyCycleNS)
+    {
+        if (channel.periodNS != this->currentPeriodNS)
+        {
+            this->writeValue(channel.periodDescriptor, this->currentPeriodNS);
+            channel.periodNS = this->currentPeriodNS;
+        }
+
+        if (channel.dutyCycleNS != this->currentDutyCycleNS)
+        {
+            this->writeValue(channel.dutyCycleDescriptor, this->currentDutyCycleNS);
+            channel.dutyCycleNS = this->currentDutyCycleNS;
+        }
     }
-    else if (color == STATUS_LED_COLOR::BLUE)
+    else
     {
-        std::ofstream dataStream;
-        dataStream.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+        this->writeValue(channel.dutyCycleDescriptor, this->currentDutyCycleNS);
+        channel.dutyCycleNS = this->currentDutyCycleNS;
 
-        dataStream.open(bluePath + enablePath, std::ios_base::out);
-        dataStream << 1U;
+        this->writeValue(channel.periodDescriptor, this->currentPeriodNS);
+        channel.periodNS = this->currentPeriodNS;
     }
-    else if (color == STATUS_LED_COLOR::GREEN)
-    {
-        std::ofstream dataStream;
-        dataStream.exceptions(std::ifstream::failbit | std::ifstream::badbit);
 
-        dataStream.open(greenPath + enablePath, std::ios_base::out);
-        dataStream << 1U;
+    return;
+}
+
+void StatusLed::writeValue (int descriptor, std::size_t value) const
+{
+    std::array<char, 24U> buffer;
+
+    const auto [ptr, error] = std::to_chars(buffer.data(), buffer.data() + std::size(buffer), value);
+
+    if (pwrite(descriptor, buffer.data(), static_cast<std::size_t>(ptr - buffer.data()), 0) < 0)
+    {
+        throw std::runtime_error { "File write error" };
     }
 
     return;
@@ -6,6 +6,9 @@
 #ifndef STATUS_LED_H_
 #define STATUS_LED_H_
 
+#include <array>
+#include <string>
+
 #include "StatusLed.Type.hpp"
 
 class StatusLed
@@ -14,6 +17,11 @@ class StatusLed
         static constexpr std::size_t periodNS       = 1'500'000'000U;
         static constexpr std::size_t dutyCycleNS    =    88'500'000U;
 
+        static constexpr std::size_t blinkPeriodNS      = 1'000'000'000U;
+        static constexpr std::size_t blinkDutyCycleNS   =   500'000'000U;
+
+        static constexpr std::size_t solidPeriodNS = 1'000'000U;    // Fast enough to dim without flicker
+
     public:
         explicit StatusLed ();
         StatusLed (const StatusLed&) = delete;
@@ -24,13 +32,36 @@ class StatusLed
 
     public:
         void updateColor (STATUS_LED_COLOR color);
+        void updatePattern (STATUS_LED_PATTERN pattern, std::size_t brightnessPercent);
         STATUS_LED_COLOR getCurrentColor () const noexcept;
 
     private:
-        void setColor (STATUS_LED_COLOR color) const;
+        // Cached state of a pwm, a sysfs file is written only when its value changes
+        struct Channel
+        {
+            int enableDescriptor;
+            int periodDescriptor;
+            int dutyCycleDescriptor;
+
+            bool isEnabled;
+            std::size_t periodNS;
+            std::size_t dutyCycleNS;
+        };
+
+    private:
+        void openChannels (const std::array<std::string, 3U> &pathArray);
+        void closeChannels () noexcept;
+        void setColor (STATUS_LED_COLOR color);
+        void setWaveform (Channel &channel) const;
+        void writeValue (int descriptor, std::size_t value) const;
 
     private:
         STATUS_LED_COLOR currentColor;
+        std::size_t currentPeriodNS;
+        std::size_t currentDutyCycleNS;
+
+    private:
+        std::array<Channel, 3U> channelArray;  // Indexed by color
 };
 
 #endif // STATUS_LED_H_
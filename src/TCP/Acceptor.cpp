@@ -5,7 +5,11 @@
 
 #include "TCP/Acceptor.hpp"
 
+#include <algorithm>
+
 #include <boost/asio/co_spawn.hpp>
+#include <boost/asio/dispatch.hpp>
+#include <boost/asio/strand.hpp>
 #include <boost/asio/detached.hpp>
 #include <boost/log/trivial.hpp>
 
@@ -17,12 +21,13 @@ using namespace TCP;
 
 Acceptor::Acceptor (Acceptor::Config config, boost::asio::io_context &context)
 :
-    timer { context },
-    acceptor { context, boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::any(), config.port) }
+    ioContext { context },
+    timer { boost::asio::make_strand(context) },
+    acceptor { timer.get_executor(), boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::any(), config.port) }
 {
     this->config = config;
 
-    this->start();
+    this->isClosed = false;
 
     return;
 }
@@ -41,12 +46,38 @@ void Acceptor::start ()
 
     this->clearConnections();
 
-    auto asyncCallback = std::bind(&Acceptor::listenAsync, this);
+    auto asyncCallback = std::bind(&Acceptor::listenAsync, this->shared_from_this());
     boost::asio::co_spawn(this->timer.get_executor(), std::move(asyncCallback), boost::asio::detached);
 
     return;
 }
 
+void Acceptor::close ()
+{
+    BOOST_LOG_TRIVIAL(info) << "TCP Acceptor : close";
+
+    auto asyncCallback = std::bind(&Acceptor::processClose, this->shared_from_this());
+    boost::asio::dispatch(this->timer.get_executor(), std::move(asyncCallback));
+
+    return;
+}
+
+// The pending coroutines end with an error, the acceptor is destroyed with the last of them
+void Acceptor::processClose ()
+{
+    this->isClosed = true;
+
+    boost::system::error_code error;
+    this->timer.cancel(error);
+
+    this->stop();
+
+    // The connections refer back to the acceptor in their callbacks
+    this->clearConnections();
+
+    return;
+}
+
 void Acceptor::stop ()
 {
     BOOST_LOG_TRIVIAL(info) << "TCP Acceptor : stop";
@@ -61,31 +92,46 @@ void Acceptor::stop ()
 
 void Acceptor::sendMessageToAll (std::string message)
 {
-    this->sendToAllConnections(std::move(message));
+    const Frame frame = makeFrame(std::move(message));
+
+    this->sendToAllConnections(frame);
 
     return;
 }
 
 void Acceptor::sendMessageToAllExceptOne (boost::asio::ip::address exceptOne, std::string message)
 {
-    this->sendToAllConnectionsExceptOne(exceptOne, std::move(message));
+    const Frame frame = makeFrame(std::move(message));
+
+    this->sendToAllConnectionsExceptOne(exceptOne, frame);
+
+    return;
+}
+
+void Acceptor::sendMessageToAllExcept (std::vector<boost::asio::ip::address> exceptArray, std::string message)
+{
+    const Frame frame = makeFrame(std::move(message));
+
+    this->sendToAllConnectionsExcept(exceptArray, frame);
 
     return;
 }
 
 void Acceptor::sendMessage (std::vector<boost::asio::ip::address> destArray, std::string message)
 {
+    const Frame frame = makeFrame(std::move(message));
+
     for (auto itr = std::cbegin(destArray); itr != std::cend(destArray); ++itr)
     {
-        this->sendToConnection(*itr, message);
+        this->sendToConnection(*itr, frame);
     }
 
     return;
 }
 
-void Acceptor::receiveMessage (std::string message)
+void Acceptor::receiveMessage (std::string_view message)
 {
-    this->config.processMessageCallback(std::move(message));
+    this->config.processMessageCallback(message);
 
     return;
 }
@@ -100,20 +146,31 @@ boost::asio::awaitable<void> Acceptor::listenAsync ()
 
         while (true)
         {
-            auto socket = std::make_unique<boost::asio::ip::tcp::socket>(this->timer.get_executor());
+            // Every connection gets its own strand, so its coroutines never run concurrently
+            auto socket = std::make_unique<boost::asio::ip::tcp::socket>(boost::asio::make_strand(this->ioContext));
 
             co_await this->acceptor.async_accept(*socket, boost::asio::use_awaitable);
 
             Connection::Config config;
-            config.processMessageCallback   = std::bind(&Acceptor::receiveMessage, this, std::placeholders::_1);
-            config.processErrorCallback     = std::bind(&Acceptor::processError, this);
+            config.processMessageCallback   = std::bind(&Acceptor::receiveMessage, this->shared_from_this(), std::placeholders::_1);
+            config.processErrorCallback     = std::bind(&Acceptor::processError, this->shared_from_this());
+            config.writeQueueLimit          = Connection::defaultWriteQueueLimit;
+            config.framing                  = FRAMING::AUTO;   // Old nodes keep the text framing
 
-            auto connection = std::make_unique<Connection>(config, std::move(socket));
+            boost::system::error_code endpointError;
+            const boost::asio::ip::address remoteIP = socket->remote_endpoint(endpointError).address();
+
+            auto connection = std::make_shared<Connection>(config, std::move(socket));
 
             const std::size_t connectionCount = this->startConnection(std::move(connection));
 
             BOOST_LOG_TRIVIAL(info) << "TCP Acceptor : acceptance success";
             BOOST_LOG_TRIVIAL(info) << "TCP Acceptor : connection count = " << connectionCount;
+
+            if ((this->config.processConnectionCallback != nullptr) && (endpointError.failed() != true))
+            {
+                this->config.processConnectionCallback(remoteIP);
+            }
         }
     }
 
@@ -124,7 +181,10 @@ boost::asio::awaitable<void> Acceptor::listenAsync ()
         BOOST_LOG_TRIVIAL(error) << "TCP Acceptor : acceptance failure";
         BOOST_LOG_TRIVIAL(error) << "TCP Acceptor : acceptance error = (" << error.value() << ") " << error.message();
 
-        this->config.processErrorCallback();
+        if (this->isClosed != true)
+        {
+            this->config.processErrorCallback();
+        }
     }
 
     co_return;
@@ -134,7 +194,7 @@ void Acceptor::processError ()
 {
     BOOST_LOG_TRIVIAL(info) << "TCP Acceptor : process error";
 
-    auto asyncCallback = std::bind(&Acceptor::clearAsync, this);
+    auto asyncCallback = std::bind(&Acceptor::clearAsync, this->shared_from_this());
     boost::asio::co_spawn(this->timer.get_executor(), std::move(asyncCallback), boost::asio::detached);
 
     return;
@@ -149,6 +209,11 @@ boost::asio::awaitable<void> Acceptor::clearAsync ()
     this->timer.expires_from_now(boost::posix_time::seconds(timeoutS));
     co_await this->timer.async_wait(boost::asio::use_awaitable);
 
+    if (this->isClosed == true)
+    {
+        co_return;
+    }
+
     BOOST_LOG_TRIVIAL(info) << "TCP Acceptor : clearing";
 
     this->clearStoppedConnections();
@@ -157,13 +222,21 @@ boost::asio::awaitable<void> Acceptor::clearAsync ()
 }
 
 
-std::size_t Acceptor::startConnection (std::unique_ptr<Connection> connection)
+std::size_t Acceptor::startConnection (std::shared_ptr<Connection> connection)
 {
     connection->start();
 
     const auto descriptor = connection->getDescriptor();
 
-    this->connectionArray.emplace(descriptor, std::move(connection));
+    // The descriptor of a stopped, not yet cleared connection may be reused by the system
+    if (auto itr = this->connectionArray.find(descriptor); itr != std::end(this->connectionArray))
+    {
+        this->eraseFromIndex(itr->second.get());
+    }
+
+    this->ipIndex.emplace(connection->getIP(), connection.get());
+
+    this->connectionArray.insert_or_assign(descriptor, std::move(connection));
 
     return this->connectionArray.size();
 }
@@ -178,48 +251,62 @@ void Acceptor::stopConnections ()
     return;
 }
 
-void Acceptor::sendToAllConnections (std::string message)
+void Acceptor::sendToAllConnections (const Frame &frame)
 {
     for (auto itrConnection = std::begin(this->connectionArray); itrConnection != std::end(this->connectionArray); ++itrConnection)
     {
-        itrConnection->second->sendMessage(message);
+        itrConnection->second->sendMessage(frame);
     }
 
     return;
 }
 
-void Acceptor::sendToAllConnectionsExceptOne (const boost::asio::ip::address &ip, std::string message)
+void Acceptor::sendToAllConnectionsExceptOne (const boost::asio::ip::address &ip, const Frame &frame)
 {
     for (auto itrConnection = std::begin(this->connectionArray); itrConnection != std::end(this->connectionArray); ++itrConnection)
     {
         if (itrConnection->second->getIP() != ip)
         {
-            itrConnection->second->sendMessage(message);
+            itrConnection->second->sendMessage(frame);
         }
     }
 
     return;
 }
 
-void Acceptor::sendToConnection (const boost::asio::ip::address &ip, std::string message)
+void Acceptor::sendToAllConnectionsExcept (const std::vector<boost::asio::ip::address> &ipArray, const Frame &frame)
 {
     for (auto itrConnection = std::begin(this->connectionArray); itrConnection != std::end(this->connectionArray); ++itrConnection)
     {
-        if (itrConnection->second->getIP() == ip)
+        if (std::find(std::cbegin(ipArray), std::cend(ipArray), itrConnection->second->getIP()) == std::cend(ipArray))
         {
-            itrConnection->second->sendMessage(message);
+            itrConnection->second->sendMessage(frame);
         }
     }
 
     return;
 }
 
+void Acceptor::sendToConnection (const boost::asio::ip::address &ip, const Frame &frame)
+{
+    const auto [itrBegin, itrEnd] = this->ipIndex.equal_range(ip);
+
+    for (auto itrConnection = itrBegin; itrConnection != itrEnd; ++itrConnection)
+    {
+        itrConnection->second->sendMessage(frame);
+    }
+
+    return;
+}
+
 std::size_t Acceptor::clearStoppedConnections ()
 {
     for (auto itrConnection = std::begin(this->connectionArray); itrConnection != std::end(this->connectionArray);)
     {
         if (itrConnection->second->isOpen() != true)
         {
+            this->eraseFromIndex(itrConnection->second.get());
+
             itrConnection = this->connectionArray.erase(itrConnection);
         }
         else
@@ -233,7 +320,37 @@ std::size_t Acceptor::clearStoppedConnections ()
 
 void Acceptor::clearConnections ()
 {
+    this->ipIndex.clear();
     this->connectionArray.clear();
 
     return;
 }
+
+void Acceptor::eraseFromIndex (const Connection *connection)
+{
+    const auto [itrBegin, itrEnd] = this->ipIndex.equal_range(connection->getIP());
+
+    for (auto itrIndex = itrBegin; itrIndex != itrEnd; ++itrIndex)
+    {
+        if (itrIndex->second == connection)
+        {
+            this->ipIndex.erase(itrIndex);
+
+            break;
+        }
+    }
+
+    return;
+}
+
+std::size_t Acceptor::AddressHash::operator() (const boost::asio::ip::address &ip) const noexcept
+{
+    if (ip.is_v4() == true)
+    {
+        return std::hash<boost::asio::ip::address_v4::uint_type>{}(ip.to_v4().to_uint());
+    }
+
+    const auto bytes = ip.to_v6().to_bytes();
+
+    return std::hash<std::string_view>{}(std::string_view { reinterpret_cast<const char*>(bytes.data()), std::size(bytes) });
+}
@@ -7,23 +7,30 @@
 #define TCP_ACCEPTOR_HPP
 
 #include <map>
+#include <memory>
+#include <unordered_map>
+#include <string_view>
 
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/deadline_timer.hpp>
 #include <boost/asio/awaitable.hpp>
 
+#include "TCP/Frame.hpp"
+
 namespace TCP
 {
     class Connection;
 
-    class Acceptor
+    // Held by shared_ptr only, its coroutines and the callbacks of its connections keep their own reference
+    class Acceptor : public std::enable_shared_from_this<Acceptor>
     {
         public:
             struct Config
             {
                 unsigned short int port;
-                std::function<void(std::string)> processMessageCallback;
+                std::function<void(std::string_view)> processMessageCallback;
                 std::function<void()> processErrorCallback;
+                std::function<void(boost::asio::ip::address)> processConnectionCallback;    // Optional, called once a connection is accepted and started
             };
 
         public:
@@ -34,31 +41,47 @@ namespace TCP
             Acceptor& operator= (Acceptor&&) = delete;
             virtual ~Acceptor ();
 
+        public:
+            void start ();  // Called once the object is fully constructed, the listening may call the overridden methods at once
+            void close ();  // Stops the listening and the connections on the acceptor strand, no error is reported afterwards
+
         public:
             void sendMessageToAll (std::string message);
             void sendMessageToAllExceptOne (boost::asio::ip::address exceptOne, std::string message);
+            void sendMessageToAllExcept (std::vector<boost::asio::ip::address> exceptArray, std::string message);
             void sendMessage (std::vector<boost::asio::ip::address> destArray, std::string message);
 
         protected:
-            virtual std::size_t startConnection (std::unique_ptr<Connection> connection);
+            virtual std::size_t startConnection (std::shared_ptr<Connection> connection);
             virtual void stopConnections ();
-            virtual void sendToAllConnections (std::string message);
-            virtual void sendToAllConnectionsExceptOne (const boost::asio::ip::address &ip, std::string message);
-            virtual void sendToConnection (const boost::asio::ip::address &ip, std::string message);
+            virtual void sendToAllConnections (const Frame &frame);
+            virtual void sendToAllConnectionsExceptOne (const boost::asio::ip::address &ip, const Frame &frame);
+            virtual void sendToAllConnectionsExcept (const std::vector<boost::asio::ip::address> &ipArray, const Frame &frame);
+            virtual void sendToConnection (const boost::asio::ip::address &ip, const Frame &frame);
             virtual std::size_t clearStoppedConnections ();
             virtual void clearConnections ();
 
-        private:
+        protected:
             using Socket = std::unique_ptr<boost::asio::ip::tcp::socket>;
             using Descriptor = boost::asio::ip::tcp::socket::native_handle_type;
-            using ConnectionContainer = std::map<Descriptor, std::unique_ptr<Connection>>;
+
+            struct AddressHash
+            {
+                std::size_t operator() (const boost::asio::ip::address &ip) const noexcept;
+            };
+
+            using ConnectionIndex = std::unordered_multimap<boost::asio::ip::address, Connection*, AddressHash>;
+
+        private:
+            using ConnectionContainer = std::map<Descriptor, std::shared_ptr<Connection>>;
 
         private:
-            void start ();
             void stop ();
+            void processClose ();
+            void eraseFromIndex (const Connection *connection);
 
         private:
-            void receiveMessage (std::string message);
+            void receiveMessage (std::string_view message);
             void processError ();
 
         private:
@@ -68,10 +91,15 @@ namespace TCP
         private:
             Config config;
 
+        private:
+            boost::asio::io_context &ioContext;
+
         private:
             boost::asio::deadline_timer timer;
             boost::asio::ip::tcp::acceptor acceptor;
+            bool isClosed;  // Used on the acceptor strand only
             ConnectionContainer connectionArray;
+            ConnectionIndex ipIndex;    // Several connections per IP are possible until the stopped ones are cleared
     };
 }
 
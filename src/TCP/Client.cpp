@@ -34,9 +34,12 @@ void Client::start (Client::Config config)
     Connection::Config connConfig;
     connConfig.processMessageCallback   = std::bind(&Client::receiveMessage, this, std::placeholders::_1);
     connConfig.processErrorCallback     = std::bind(&Client::processError, this);
+    connConfig.processConnectCallback   = this->config.processConnectCallback;
+    connConfig.writeQueueLimit          = Connection::defaultWriteQueueLimit;
+    connConfig.framing                  = this->config.framing;
 
     auto socket = std::make_unique<boost::asio::ip::tcp::socket>(this->timer.get_executor());
-    this->connection = std::make_unique<Connection>(connConfig, std::move(socket));
+    this->connection = std::make_shared<Connection>(connConfig, std::move(socket));
 
     boost::asio::ip::tcp::endpoint endPoint { boost::asio::ip::address::from_string(this->config.ip), this->config.port };
     this->connection->connect(boost::move(endPoint));
@@ -63,13 +66,13 @@ void Client::sendMessage (std::string message)
     return;
 }
 
-void Client::receiveMessage (std::string message)
+void Client::receiveMessage (std::string_view message)
 {
     BOOST_LOG_TRIVIAL(info) << "TCP Client : receive message = " << message;
 
     if (this->config.processMessageCallback != nullptr)
     {
-        this->config.processMessageCallback(std::move(message));
+        this->config.processMessageCallback(message);
     }
 
     return;
@@ -79,6 +82,11 @@ void Client::processError ()
 {
     BOOST_LOG_TRIVIAL(info) << "TCP Client : process error";
 
+    if (this->config.processErrorCallback != nullptr)
+    {
+        this->config.processErrorCallback();
+    }
+
     auto asyncCallback = std::bind(&Client::reconnectAsync, this);
     boost::asio::co_spawn(this->timer.get_executor(), std::move(asyncCallback), boost::asio::detached);
 
@@ -6,9 +6,13 @@
 #ifndef TCP_CLIENT_HPP
 #define TCP_CLIENT_HPP
 
+#include <string_view>
+
 #include <boost/asio/deadline_timer.hpp>
 #include <boost/asio/awaitable.hpp>
 
+#include "TCP/Frame.hpp"
+
 namespace TCP
 {
     class Connection;
@@ -20,7 +24,10 @@ namespace TCP
             {
                 std::string ip;
                 unsigned short int port;
-                std::function<void(std::string)> processMessageCallback;
+                std::function<void(std::string_view)> processMessageCallback;
+                std::function<void()> processConnectCallback;   // Called after every (re)connection
+                std::function<void()> processErrorCallback;     // Optional, called once the connection is lost or fails
+                FRAMING framing;
             };
             
         public:
@@ -39,7 +46,7 @@ namespace TCP
             void sendMessage (std::string message);
         
         private:
-            void receiveMessage (std::string message);
+            void receiveMessage (std::string_view message);
             void processError ();
 
         private:
@@ -49,7 +56,7 @@ namespace TCP
             Config config;
 
         private:
-            std::unique_ptr<Connection> connection;
+            std::shared_ptr<Connection> connection;
             boost::asio::deadline_timer timer;
     };
 }
@@ -5,6 +5,8 @@
 
 #include "TCP/ConcurrentAcceptor.hpp"
 
+#include <algorithm>
+
 #include "TCP/Connection.hpp"
 
 
@@ -13,69 +15,163 @@ using namespace TCP;
 
 ConcurrentAcceptor::ConcurrentAcceptor (Acceptor::Config config, boost::asio::io_context &context)
 :
-    Acceptor { config, context }
+    Acceptor { config, context },
+    registry { std::make_shared<const Registry>() }
 {
     return;
 }
 
-ConcurrentAcceptor::~ConcurrentAcceptor () = default;
+ConcurrentAcceptor::~ConcurrentAcceptor ()
+{
+    // The base destructor can not reach the connections of the registry
+    this->stopConnections();
+
+    return;
+}
 
 
-std::size_t ConcurrentAcceptor::startConnection (std::unique_ptr<Connection> connection)
+std::size_t ConcurrentAcceptor::startConnection (std::shared_ptr<Connection> connection)
 {
-    std::scoped_lock writeLock { this->mutex };
+    connection->start();
+
+    const auto descriptor = connection->getDescriptor();
+
+    std::scoped_lock writeLock { this->writeMutex };
+
+    auto newRegistry = std::make_shared<Registry>(*this->registry.load());
 
-    return this->Acceptor::startConnection(std::move(connection));
+    // The descriptor of a stopped, not yet cleared connection may be reused by the system
+    if (auto itr = newRegistry->connectionArray.find(descriptor); itr != std::end(newRegistry->connectionArray))
+    {
+        const auto [itrBegin, itrEnd] = newRegistry->ipIndex.equal_range(itr->second->getIP());
+
+        for (auto itrIndex = itrBegin; itrIndex != itrEnd; ++itrIndex)
+        {
+            if (itrIndex->second == itr->second.get())
+            {
+                newRegistry->ipIndex.erase(itrIndex);
+
+                break;
+            }
+        }
+    }
+
+    newRegistry->ipIndex.emplace(connection->getIP(), connection.get());
+    newRegistry->connectionArray.insert_or_assign(descriptor, std::move(connection));
+
+    const std::size_t connectionCount = std::size(newRegistry->connectionArray);
+
+    this->publish(std::move(newRegistry));
+
+    return connectionCount;
 }
 
 void ConcurrentAcceptor::stopConnections ()
 {
-    std::shared_lock readLock { this->mutex };
+    const auto snapshot = this->registry.load();
 
-    this->Acceptor::stopConnections();
+    for (auto itrConnection = std::cbegin(snapshot->connectionArray); itrConnection != std::cend(snapshot->connectionArray); ++itrConnection)
+    {
+        itrConnection->second->stop();
+    }
 
     return;
 }
 
-void ConcurrentAcceptor::sendToAllConnections (std::string message)
+void ConcurrentAcceptor::sendToAllConnections (const Frame &frame)
 {
-    std::shared_lock readLock { this->mutex };
+    const auto snapshot = this->registry.load();
 
-    this->Acceptor::sendToAllConnections(std::move(message));
+    for (auto itrConnection = std::cbegin(snapshot->connectionArray); itrConnection != std::cend(snapshot->connectionArray); ++itrConnection)
+    {
+        itrConnection->second->sendMessage(frame);
+    }
 
     return;
 }
 
-void ConcurrentAcceptor::sendToAllConnectionsExceptOne (const boost::asio::ip::address &ip, std::string message)
+void ConcurrentAcceptor::sendToAllConnectionsExceptOne (const boost::asio::ip::address &ip, const Frame &frame)
 {
-    std::shared_lock readLock { this->mutex };
+    const auto snapshot = this->registry.load();
 
-    this->Acceptor::sendToAllConnectionsExceptOne(ip, std::move(message));
+    for (auto itrConnection = std::cbegin(snapshot->connectionArray); itrConnection != std::cend(snapshot->connectionArray); ++itrConnection)
+    {
+        if (itrConnection->second->getIP() != ip)
+        {
+            itrConnection->second->sendMessage(frame);
+        }
+    }
 
     return;
 }
 
-void ConcurrentAcceptor::sendToConnection (const boost::asio::ip::address &ip, std::string message)
+void ConcurrentAcceptor::sendToAllConnectionsExcept (const std::vector<boost::asio::ip::address> &ipArray, const Frame &frame)
 {
-    std::shared_lock readLock { this->mutex };
+    const auto snapshot = this->registry.load();
 
-    this->Acceptor::sendToConnection(ip, std::move(message));
+    for (auto itrConnection = std::cbegin(snapshot->connectionArray); itrConnection != std::cend(snapshot->connectionArray); ++itrConnection)
+    {
+        if (std::find(std::cbegin(ipArray), std::cend(ipArray), itrConnection->second->getIP()) == std::cend(ipArray))
+        {
+            itrConnection->second->sendMessage(frame);
+        }
+    }
+
+    return;
+}
+
+void ConcurrentAcceptor::sendToConnection (const boost::asio::ip::address &ip, const Frame &frame)
+{
+    const auto snapshot = this->registry.load();
+
+    const auto [itrBegin, itrEnd] = snapshot->ipIndex.equal_range(ip);
+
+    for (auto itrConnection = itrBegin; itrConnection != itrEnd; ++itrConnection)
+    {
+        itrConnection->second->sendMessage(frame);
+    }
 
     return;
 }
 
 std::size_t ConcurrentAcceptor::clearStoppedConnections ()
 {
-    std::scoped_lock writeLock { this->mutex };
+    std::scoped_lock writeLock { this->writeMutex };
+
+    auto newRegistry = std::make_shared<Registry>();
+
+    const auto snapshot = this->registry.load();
+
+    for (auto itrConnection = std::cbegin(snapshot->connectionArray); itrConnection != std::cend(snapshot->connectionArray); ++itrConnection)
+    {
+        if (itrConnection->second->isOpen() == true)
+        {
+            newRegistry->ipIndex.emplace(itrConnection->second->getIP(), itrConnection->second.get());
+            newRegistry->connectionArray.emplace(itrConnection->first, itrConnection->second);
+        }
+    }
 
-    return this->Acceptor::clearStoppedConnections();
+    const std::size_t connectionCount = std::size(newRegistry->connectionArray);
+
+    // A stopped connection is destroyed once the last sender drops the previous snapshot
+    // and its pending coroutines, which hold their own reference, have ended
+    this->publish(std::move(newRegistry));
+
+    return connectionCount;
 }
 
 void ConcurrentAcceptor::clearConnections ()
 {
-    std::scoped_lock writeLock { this->mutex };
+    std::scoped_lock writeLock { this->writeMutex };
 
-    this->Acceptor::clearConnections();
+    this->publish(std::make_shared<const Registry>());
+
+    return;
+}
+
+void ConcurrentAcceptor::publish (std::shared_ptr<const Registry> newRegistry)
+{
+    this->registry.store(std::move(newRegistry));
 
     return;
 }
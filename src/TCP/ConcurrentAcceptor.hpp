@@ -6,7 +6,8 @@
 #ifndef TCP_CONCURRENT_ACCEPTOR_HPP
 #define TCP_CONCURRENT_ACCEPTOR_HPP
 
-#include <shared_mutex>
+#include <mutex>
+#include <atomic>
 
 #include "TCP/Acceptor.hpp"
 
@@ -23,16 +24,29 @@ namespace TCP
             virtual ~ConcurrentAcceptor ();
 
         protected:
-            virtual std::size_t startConnection (std::unique_ptr<Connection> connection) override final;
+            virtual std::size_t startConnection (std::shared_ptr<Connection> connection) override final;
             virtual void stopConnections () override final;
-            virtual void sendToAllConnections (std::string message) override final;
-            virtual void sendToAllConnectionsExceptOne (const boost::asio::ip::address &ip, std::string message) override final;
-            virtual void sendToConnection (const boost::asio::ip::address &ip, std::string message) override final;
+            virtual void sendToAllConnections (const Frame &frame) override final;
+            virtual void sendToAllConnectionsExceptOne (const boost::asio::ip::address &ip, const Frame &frame) override final;
+            virtual void sendToAllConnectionsExcept (const std::vector<boost::asio::ip::address> &ipArray, const Frame &frame) override final;
+            virtual void sendToConnection (const boost::asio::ip::address &ip, const Frame &frame) override final;
             virtual std::size_t clearStoppedConnections () override final;
             virtual void clearConnections () override final;
 
         private:
-            std::shared_mutex mutex;
+            // Immutable snapshot of the connections, the send paths read it without locking
+            struct Registry
+            {
+                std::map<Descriptor, std::shared_ptr<Connection>> connectionArray;
+                ConnectionIndex ipIndex;
+            };
+
+        private:
+            void publish (std::shared_ptr<const Registry> newRegistry);
+
+        private:
+            std::mutex writeMutex;  // Serializes the snapshot writers only
+            std::atomic<std::shared_ptr<const Registry>> registry;
     };
 }
 
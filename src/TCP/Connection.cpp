@@ -5,9 +5,10 @@
 
 #include "TCP/Connection.hpp"
 
-#include <boost/asio/read_until.hpp>
+#include <cstring>
+
 #include <boost/asio/write.hpp>
-#include <boost/asio/streambuf.hpp>
+#include <boost/asio/dispatch.hpp>
 #include <boost/asio/co_spawn.hpp>
 #include <boost/asio/detached.hpp>
 #include <boost/log/trivial.hpp>
@@ -16,12 +17,20 @@
 using namespace TCP;
 
 
+// Returns the size of the binary header, or zero while the header is incomplete
+static std::size_t parseBinaryHeader (const std::uint8_t *data, std::size_t size, std::uint8_t &type, std::size_t &length);
+
 Connection::Connection (Connection::Config config, Connection::Socket socket)
 {
     this->config = config;
 
     this->socket = std::move(socket);
 
+    this->framing = this->config.framing;
+
+    this->isWriting = false;
+    this->isStopped = true;
+
     return;
 }
 
@@ -38,7 +47,13 @@ void Connection::start ()
     this->ip            = socket->remote_endpoint().address();
     this->descriptor    = socket->native_handle();
 
-    auto asyncCallback = std::bind(&Connection::readAsync, this);
+    {
+        std::scoped_lock lock { this->writeMutex };
+
+        this->isStopped = false;
+    }
+
+    auto asyncCallback = std::bind(&Connection::readAsync, this->shared_from_this());
     boost::asio::co_spawn(this->socket->get_executor(), std::move(asyncCallback), boost::asio::detached);
 
     return;
@@ -50,8 +65,14 @@ void Connection::connect (boost::asio::ip::tcp::endpoint endPoint)
     {
         this->socket->open(boost::asio::ip::tcp::v4());
     }
-        
-    auto asyncCallback = std::bind(&Connection::connectAsync, this, boost::move(endPoint));
+
+    {
+        std::scoped_lock lock { this->writeMutex };
+
+        this->isStopped = false;
+    }
+
+    auto asyncCallback = std::bind(&Connection::connectAsync, this->shared_from_this(), boost::move(endPoint));
     boost::asio::co_spawn(this->socket->get_executor(), std::move(asyncCallback), boost::asio::detached);
 
     return;
@@ -68,8 +89,19 @@ boost::asio::awaitable<void> Connection::connectAsync (boost::asio::ip::tcp::end
 
         BOOST_LOG_TRIVIAL(info) << "TCP Connection : (" << this->ip << "/" << this->descriptor << ") socket connection success";
 
-        auto asyncCallback = std::bind(&Connection::readAsync, this);
+        auto asyncCallback = std::bind(&Connection::readAsync, this->shared_from_this());
         boost::asio::co_spawn(this->socket->get_executor(), std::move(asyncCallback), boost::asio::detached);
+
+        // The offer precedes every message of the connection
+        if (this->config.framing == FRAMING::NEGOTIATED)
+        {
+            this->sendMessage(std::string { Connection::binaryOffer });
+        }
+
+        if (this->config.processConnectCallback != nullptr)
+        {
+            this->config.processConnectCallback();
+        }
     }
 
     catch (const boost::system::system_error &exp)
@@ -93,20 +125,139 @@ boost::asio::awaitable<void> Connection::readAsync ()
     {
         BOOST_LOG_TRIVIAL(info) << "TCP Connection : (" << this->ip << "/" << this->descriptor << ") socket is reading";
 
-        boost::asio::streambuf readBuffer;
+        if (std::size(this->readBuffer) < Connection::readBufferSize)
+        {
+            this->readBuffer.resize(Connection::readBufferSize);
+        }
+
+        this->framing = this->config.framing;
+
+        std::size_t messageBegin    = 0U;   // First byte of the incomplete message
+        std::size_t scanBegin       = 0U;   // First byte not yet checked for the delimiter
+        std::size_t dataEnd         = 0U;   // One past the last received byte
 
         while (true)
         {
-            const auto bytesTransferred = co_await boost::asio::async_read_until(*this->socket.get(), readBuffer,
-                                                                                Connection::msgDelimiter, boost::asio::use_awaitable);
+            // Move the incomplete message to the front, so every message stays contiguous
+            if (messageBegin != 0U)
+            {
+                std::memmove(this->readBuffer.data(), this->readBuffer.data() + messageBegin, dataEnd - messageBegin);
+
+                scanBegin   -= messageBegin;
+                dataEnd     -= messageBegin;
+                messageBegin = 0U;
+            }
+
+            if (dataEnd == std::size(this->readBuffer))
+            {
+                if (std::size(this->readBuffer) >= Connection::maxMessageSize)
+                {
+                    throw boost::system::system_error { boost::asio::error::message_size };
+                }
+
+                this->readBuffer.resize(std::min(std::size(this->readBuffer) * 2U, Connection::maxMessageSize));
+            }
+
+            const auto bytesTransferred = co_await this->socket->async_read_some(boost::asio::buffer(this->readBuffer.data() + dataEnd,
+                                                                                                     std::size(this->readBuffer) - dataEnd),
+                                                                                 boost::asio::use_awaitable);
+            dataEnd += bytesTransferred;
 
             BOOST_LOG_TRIVIAL(info) << "TCP Connection : (" << this->ip << "/" << this->descriptor << ") message receiving success";
             BOOST_LOG_TRIVIAL(info) << "TCP Connection : (" << this->ip << "/" << this->descriptor << ") bytes transferred = " << bytesTransferred;
 
-            std::ostringstream inputMessage;
-            inputMessage << &readBuffer;
-
-            this->config.processMessageCallback(inputMessage.str());
+            // Hand every complete message to the consumer straight from the read buffer,
+            // the framing is detected per message by its first byte
+            while (messageBegin != dataEnd)
+            {
+                const char *data = this->readBuffer.data();
+
+                if (static_cast<std::uint8_t>(data[messageBegin]) == Connection::binaryMarker)
+                {
+                    std::uint8_t type;
+                    std::size_t length;
+                    const std::size_t headerSize = parseBinaryHeader(reinterpret_cast<const std::uint8_t*>(data + messageBegin),
+                                                                     dataEnd - messageBegin, type, length);
+                    if (headerSize == 0U)
+                    {
+                        break;
+                    }
+
+                    if (length > Connection::maxMessageSize - headerSize)
+                    {
+                        throw boost::system::system_error { boost::asio::error::message_size };
+                    }
+
+                    const std::size_t messageEnd = messageBegin + headerSize + length;
+
+                    if (messageEnd > dataEnd)
+                    {
+                        // The length is known, so the buffer gets room for the whole message at once
+                        if (messageEnd - messageBegin > std::size(this->readBuffer))
+                        {
+                            this->readBuffer.resize(Connection::maxMessageSize);
+                        }
+
+                        scanBegin = dataEnd;
+
+                        break;
+                    }
+
+                    if (this->framing == FRAMING::AUTO)
+                    {
+                        this->framing = FRAMING::BINARY;
+
+                        BOOST_LOG_TRIVIAL(info) << "TCP Connection : (" << this->ip << "/" << this->descriptor << ") binary framing is detected";
+                    }
+
+                    if (type == Connection::binaryDataType)
+                    {
+                        const std::string_view message { data + messageBegin + headerSize, length };
+
+                        if (this->processFraming(message) != true)
+                        {
+                            this->config.processMessageCallback(message);
+                        }
+                    }
+                    else
+                    {
+                        BOOST_LOG_TRIVIAL(warning) << "TCP Connection : (" << this->ip << "/" << this->descriptor << ") unknown message type = "
+                                                   << static_cast<unsigned int>(type) << ", message is skipped";
+                    }
+
+                    messageBegin    = messageEnd;
+                    scanBegin       = messageBegin;
+                }
+                else
+                {
+                    const void *delimiter = std::memchr(data + scanBegin, Connection::msgDelimiter, dataEnd - scanBegin);
+
+                    if (delimiter == nullptr)
+                    {
+                        scanBegin = dataEnd;
+
+                        break;
+                    }
+
+                    if (this->framing == FRAMING::AUTO)
+                    {
+                        this->framing = FRAMING::TEXT;
+
+                        BOOST_LOG_TRIVIAL(info) << "TCP Connection : (" << this->ip << "/" << this->descriptor << ") text framing is detected";
+                    }
+
+                    const std::size_t messageEnd = static_cast<const char*>(delimiter) - data;
+                    const std::string_view message { data + messageBegin, messageEnd - messageBegin };
+
+                    if (this->processFraming(message) != true)
+                    {
+                        this->config.processMessageCallback(message);
+                    }
+
+                    messageBegin    = messageEnd + 1U;
+                    scanBegin       = messageBegin;
+                }
+            }
         }
     }
 
@@ -122,6 +273,13 @@ boost::asio::awaitable<void> Connection::readAsync ()
         {
             BOOST_LOG_TRIVIAL(error) << "TCP Connection : (" << this->ip << "/" << this->descriptor << ") message receiving EOF";
 
+            this->stop();
+            this->config.processErrorCallback();
+        }
+        else if (error == boost::asio::error::message_size)
+        {
+            BOOST_LOG_TRIVIAL(error) << "TCP Connection : (" << this->ip << "/" << this->descriptor << ") message is too long";
+
             this->stop();
             this->config.processErrorCallback();
         }
@@ -130,7 +288,55 @@ boost::asio::awaitable<void> Connection::readAsync ()
     co_return;
 }
 
+// Returns true for the framing negotiation messages, they are not passed to the consumer
+bool Connection::processFraming (std::string_view message)
+{
+    if (message == Connection::binaryOffer)
+    {
+        if ((this->config.framing == FRAMING::AUTO) || (this->config.framing == FRAMING::NEGOTIATED))
+        {
+            // Every reader detects the framing per message, so the answer may already leave in the binary one
+            this->sendMessage(std::string { Connection::binaryAccept });
+            this->framing = FRAMING::BINARY;
+
+            BOOST_LOG_TRIVIAL(info) << "TCP Connection : (" << this->ip << "/" << this->descriptor << ") binary framing is accepted";
+        }
+
+        return true;
+    }
+
+    if (message == Connection::binaryAccept)
+    {
+        if (this->config.framing == FRAMING::NEGOTIATED)
+        {
+            this->framing = FRAMING::BINARY;
+
+            BOOST_LOG_TRIVIAL(info) << "TCP Connection : (" << this->ip << "/" << this->descriptor << ") binary framing is negotiated";
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
 void Connection::stop () noexcept
+{
+    {
+        std::scoped_lock lock { this->writeMutex };
+
+        this->isStopped = true;
+        this->writeQueue.clear();
+    }
+
+    // A socket is not safe for concurrent use, its coroutines run on the connection strand
+    auto asyncCallback = std::bind(&Connection::closeSocket, this->shared_from_this());
+    boost::asio::dispatch(this->socket->get_executor(), std::move(asyncCallback));
+
+    return;
+}
+
+void Connection::closeSocket () noexcept
 {
     boost::system::error_code error;
     this->socket->shutdown(boost::asio::ip::tcp::socket::shutdown_both, error);
@@ -141,7 +347,7 @@ void Connection::stop () noexcept
 
 bool Connection::isOpen () const
 {
-    return this->socket->is_open();
+    return (this->isStopped != true);
 }
 
 boost::asio::ip::address Connection::getIP () const
@@ -156,28 +362,102 @@ Connection::Descriptor Connection::getDescriptor () const noexcept
 
 void Connection::sendMessage (std::string message)
 {
-    if (message.back() != Connection::msgDelimiter)
+    this->sendMessage(makeFrame(std::move(message)));
+
+    return;
+}
+
+void Connection::sendMessage (Frame frame)
+{
+    if (frame->message.empty() == true)
     {
-        message.push_back(Connection::msgDelimiter);
+        return;
     }
 
-    auto asyncCallback = std::bind(&Connection::writeAsync, this, std::move(message));
-    boost::asio::co_spawn(this->socket->get_executor(), std::move(asyncCallback), boost::asio::detached);
+    std::scoped_lock lock { this->writeMutex };
+
+    if (this->isStopped == true)
+    {
+        return;
+    }
+
+    if (std::size(this->writeQueue) >= this->config.writeQueueLimit)
+    {
+        BOOST_LOG_TRIVIAL(warning) << "TCP Connection : (" << this->ip << "/" << this->descriptor << ") write queue is full, message is dropped";
+
+        return;
+    }
+
+    this->writeQueue.push_back(std::move(frame));
+
+    if (this->isWriting == false)
+    {
+        this->isWriting = true;
+
+        auto asyncCallback = std::bind(&Connection::writeAsync, this->shared_from_this());
+        boost::asio::co_spawn(this->socket->get_executor(), std::move(asyncCallback), boost::asio::detached);
+    }
 
     return;
 }
 
-boost::asio::awaitable<void> Connection::writeAsync (std::string message)
+boost::asio::awaitable<void> Connection::writeAsync ()
 {
     try
     {
-        BOOST_LOG_TRIVIAL(info) << "TCP Connection : (" << this->ip << "/" << this->descriptor << ") socket is writing";
+        std::vector<boost::asio::const_buffer> bufferArray;
+
+        // Drain everything queued since the previous write into a single gather write
+        while (true)
+        {
+            {
+                std::scoped_lock lock { this->writeMutex };
+
+                if (this->writeQueue.empty() == true)
+                {
+                    this->isWriting = false;
+
+                    break;
+                }
+
+                this->writingArray.swap(this->writeQueue);
+            }
+
+            bufferArray.clear();
 
-        const auto bytesTransferred = co_await boost::asio::async_write(*this->socket.get(),
-                                                                        boost::asio::buffer(message), boost::asio::use_awaitable);
+            bufferArray.reserve(std::size(this->writingArray) * 2U);
 
-        BOOST_LOG_TRIVIAL(info) << "TCP Connection : (" << this->ip << "/" << this->descriptor << ") message sending success";
-        BOOST_LOG_TRIVIAL(info) << "TCP Connection : (" << this->ip << "/" << this->descriptor << ") bytes transferred = " << bytesTransferred;
+            for (auto itr = std::cbegin(this->writingArray); itr != std::cend(this->writingArray); ++itr)
+            {
+                const FrameData &frame = **itr;
+
+                if (this->framing == FRAMING::BINARY)
+                {
+                    bufferArray.push_back(boost::asio::buffer(frame.binaryHeader.data(), frame.binaryHeaderSize));
+                    bufferArray.push_back(boost::asio::buffer(frame.message));
+                }
+                else if (frame.isText == true)
+                {
+                    bufferArray.push_back(boost::asio::buffer(frame.message));
+                    bufferArray.push_back(boost::asio::buffer(&Connection::msgDelimiter, 1U));
+                }
+                else
+                {
+                    // The peer would split it, for instance a binary encoded message relayed to a text node
+                    BOOST_LOG_TRIVIAL(warning) << "TCP Connection : (" << this->ip << "/" << this->descriptor << ") message holds the delimiter, it is dropped";
+                }
+            }
+
+            BOOST_LOG_TRIVIAL(info) << "TCP Connection : (" << this->ip << "/" << this->descriptor << ") socket is writing";
+
+            const auto bytesTransferred = co_await boost::asio::async_write(*this->socket.get(), bufferArray, boost::asio::use_awaitable);
+
+            BOOST_LOG_TRIVIAL(info) << "TCP Connection : (" << this->ip << "/" << this->descriptor << ") message sending success";
+            BOOST_LOG_TRIVIAL(info) << "TCP Connection : (" << this->ip << "/" << this->descriptor << ") messages sent = " << std::size(this->writingArray)
+                                    << ", bytes transferred = " << bytesTransferred;
+
+            this->writingArray.clear();
+        }
     }
 
     catch (const boost::system::system_error &exp)
@@ -187,7 +467,45 @@ boost::asio::awaitable<void> Connection::writeAsync (std::string message)
         BOOST_LOG_TRIVIAL(error) << "TCP Connection : (" << this->ip << "/" << this->descriptor << ") message sending failure";
         BOOST_LOG_TRIVIAL(error) << "TCP Connection : (" << this->ip << "/" << this->descriptor
                                  << ") error = (" << error.value() << ") " << error.message();
+
+        this->writingArray.clear();
+
+        std::scoped_lock lock { this->writeMutex };
+
+        this->writeQueue.clear();
+        this->isWriting = false;
     }
 
     co_return;
 }
+
+std::size_t parseBinaryHeader (const std::uint8_t *data, std::size_t size, std::uint8_t &type, std::size_t &length)
+{
+    constexpr std::size_t maxLengthSize = 5U;
+
+    if (size < 3U)
+    {
+        return 0U;
+    }
+
+    type    = data[1];
+    length  = 0U;
+
+    for (std::size_t i = 0U; i < maxLengthSize; ++i)
+    {
+        if (2U + i == size)
+        {
+            return 0U;
+        }
+
+        const std::uint8_t byte = data[2U + i];
+        length |= static_cast<std::size_t>(byte & 0x7FU) << (7U * i);
+
+        if ((byte & 0x80U) == 0U)
+        {
+            return 2U + i + 1U;
+        }
+    }
+
+    throw boost::system::system_error { boost::asio::error::message_size };
+}
@@ -6,15 +6,32 @@
 #ifndef TCP_CONNECTION_HPP
 #define TCP_CONNECTION_HPP
 
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <string_view>
+
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/awaitable.hpp>
 
+#include "TCP/Frame.hpp"
+
 namespace TCP
 {
-    class Connection
+    // Held by shared_ptr only, every coroutine keeps its own reference,
+    // so the last owner may drop it while a read or a write is pending
+    class Connection : public std::enable_shared_from_this<Connection>
     {
         public:
             static constexpr char msgDelimiter = '\n';
+            static constexpr std::uint8_t binaryMarker = 0xFEU;     // Never present in UTF-8 text
+            static constexpr std::uint8_t binaryDataType = 0U;
+            static constexpr std::string_view binaryOffer = "#binary?";     // Text line, servers without the binary framing drop it as malformed
+            static constexpr std::string_view binaryAccept = "#binary!";
+            static constexpr std::size_t defaultWriteQueueLimit = 256U;
+            static constexpr std::size_t readBufferSize = 4U * 1024U;
+            static constexpr std::size_t maxMessageSize = 64U * 1024U;
 
         public:
             using Socket = std::unique_ptr<boost::asio::ip::tcp::socket>;
@@ -23,8 +40,11 @@ namespace TCP
         public:
             struct Config
             {
-                std::function<void(std::string)> processMessageCallback;
+                std::function<void(std::string_view)> processMessageCallback;   // The view is valid only during the call
                 std::function<void()> processErrorCallback;
+                std::function<void()> processConnectCallback;   // Optional, called once the connection is established by connect ()
+                std::size_t writeQueueLimit;    // Pending messages above the limit are dropped
+                FRAMING framing;                // Framing of the sent messages
             };
 
         public:
@@ -38,20 +58,25 @@ namespace TCP
         public:
             void start ();
             void connect (boost::asio::ip::tcp::endpoint endPoint);
-            void stop () noexcept;
+            void stop () noexcept;     // The socket is closed on the strand of the connection
 
         public:
             void sendMessage (std::string message);
+            void sendMessage (Frame frame);
 
         public:
             bool isOpen () const;
             boost::asio::ip::address getIP () const;
             Descriptor getDescriptor () const noexcept;
 
+        private:
+            bool processFraming (std::string_view message);
+            void closeSocket () noexcept;
+
         private:
             boost::asio::awaitable<void> connectAsync (boost::asio::ip::tcp::endpoint endPoint);
             boost::asio::awaitable<void> readAsync ();
-            boost::asio::awaitable<void> writeAsync (std::string message);
+            boost::asio::awaitable<void> writeAsync ();
 
         private:
             Config config;
@@ -60,6 +85,17 @@ namespace TCP
             Socket socket;
             boost::asio::ip::address ip;
             Descriptor descriptor;
+
+        private:
+            std::vector<char> readBuffer;
+            FRAMING framing;
+
+        private:
+            std::mutex writeMutex;  // Messages may be queued from the strands of other connections
+            std::vector<Frame> writeQueue;
+            std::vector<Frame> writingArray;
+            bool isWriting;
+            std::atomic<bool> isStopped;    // Set under the write mutex, so nothing is queued once set, read without it by isOpen ()
     };
 }
 
@@ -0,0 +1,42 @@
+/************************************************************
+ *   Author : German Mundinger
+ *   Date   : 2024
+ ************************************************************/
+
+#include "TCP/Frame.hpp"
+
+#include <cstring>
+
+#include "TCP/Connection.hpp"
+
+
+// A binary payload may hold the delimiter anywhere, even at its end, so the message is kept untouched
+TCP::Frame TCP::makeFrame (std::string message)
+{
+    auto frame = std::make_shared<FrameData>();
+    frame->message = std::move(message);
+    frame->isText = (std::memchr(frame->message.data(), Connection::msgDelimiter, std::size(frame->message)) == nullptr);
+
+    // Binary header : marker, type, length as unsigned LEB128
+    frame->binaryHeader[0] = Connection::binaryMarker;
+    frame->binaryHeader[1] = Connection::binaryDataType;
+    frame->binaryHeaderSize = 2U;
+
+    std::size_t length = std::size(frame->message);
+
+    do
+    {
+        std::uint8_t byte = static_cast<std::uint8_t>(length & 0x7FU);
+        length >>= 7U;
+
+        if (length != 0U)
+        {
+            byte |= 0x80U;
+        }
+
+        frame->binaryHeader[frame->binaryHeaderSize++] = byte;
+    }
+    while (length != 0U);
+
+    return frame;
+}
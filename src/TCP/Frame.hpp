@@ -0,0 +1,40 @@
+/************************************************************
+ *   Author : German Mundinger
+ *   Date   : 2024
+ ************************************************************/
+
+#ifndef TCP_FRAME_HPP
+#define TCP_FRAME_HPP
+
+#include <array>
+#include <memory>
+#include <string>
+#include <cstdint>
+
+namespace TCP
+{
+    enum class FRAMING : std::uint8_t
+    {
+        TEXT = 0U,  // Message, delimiter
+        BINARY,     // Marker, type, varint length, message
+        AUTO,       // Text until the first received message, then the framing of the peer, a binary offer is accepted
+        NEGOTIATED  // Text, the binary framing is offered on connection and used once the peer accepts it
+    };
+
+    struct FrameData
+    {
+        std::string message;    // Without delimiter
+        bool isText;            // No delimiter inside, so the message fits the text framing
+
+        std::array<std::uint8_t, 8U> binaryHeader;
+        std::size_t binaryHeaderSize;
+    };
+
+    // Immutable message prepared for both framings,
+    // one instance is shared by all the connections it is sent to
+    using Frame = std::shared_ptr<const FrameData>;
+
+    Frame makeFrame (std::string message);
+}
+
+#endif // TCP_FRAME_HPP
@@ -9,7 +9,7 @@
 #include <boost/asio/detached.hpp>
 #include <boost/log/trivial.hpp>
 
-#include "TCP/Acceptor.hpp"
+#include "TCP/ConcurrentAcceptor.hpp"
 
 
 using namespace TCP;
@@ -18,6 +18,7 @@ using namespace TCP;
 Server::Server (boost::asio::io_context &context)
 :
     ioContext { context },
+    isStarted { false },
     timer { context }
 {
     return;
@@ -33,11 +34,20 @@ void Server::start (Server::Config config)
     BOOST_LOG_TRIVIAL(info) << "TCP Server : start";
 
     Acceptor::Config acceptorConfig;
-    acceptorConfig.port                     = this->config.port;
-    acceptorConfig.processMessageCallback   = std::bind(&Server::receiveMessage, this, std::placeholders::_1);
-    acceptorConfig.processErrorCallback     = std::bind(&Server::processError, this);
+    acceptorConfig.port                         = this->config.port;
+    acceptorConfig.processMessageCallback       = std::bind(&Server::receiveMessage, this, std::placeholders::_1);
+    acceptorConfig.processErrorCallback         = std::bind(&Server::processError, this);
+    acceptorConfig.processConnectionCallback    = this->config.processConnectionCallback;
 
-    this->acceptor = std::make_unique<Acceptor>(acceptorConfig, this->ioContext);
+    auto newAcceptor = std::make_shared<ConcurrentAcceptor>(acceptorConfig, this->ioContext);
+    newAcceptor->start();
+
+    this->isStarted = true;
+
+    if (const auto oldAcceptor = this->acceptor.exchange(std::move(newAcceptor)); oldAcceptor != nullptr)
+    {
+        oldAcceptor->close();
+    }
 
     return;
 }
@@ -46,7 +56,12 @@ void Server::stop ()
 {
     BOOST_LOG_TRIVIAL(info) << "TCP Server : stop";
 
-    this->acceptor.reset();
+    this->isStarted = false;
+
+    if (const auto oldAcceptor = this->acceptor.exchange(nullptr); oldAcceptor != nullptr)
+    {
+        oldAcceptor->close();
+    }
 
     return;
 }
@@ -55,7 +70,10 @@ void Server::sendMessageToAll (std::string message)
 {
     BOOST_LOG_TRIVIAL(info) << "TCP Server : send message = " << message;
 
-    this->acceptor->sendMessageToAll(std::move(message));
+    if (const auto currentAcceptor = this->acceptor.load(); currentAcceptor != nullptr)
+    {
+        currentAcceptor->sendMessageToAll(std::move(message));
+    }
 
     return;
 }
@@ -64,7 +82,22 @@ void Server::sendMessageToAllExceptOne (boost::asio::ip::address exceptOne, std:
 {
     BOOST_LOG_TRIVIAL(info) << "TCP Server : send message = " << message;
 
-    this->acceptor->sendMessageToAllExceptOne(exceptOne, std::move(message));
+    if (const auto currentAcceptor = this->acceptor.load(); currentAcceptor != nullptr)
+    {
+        currentAcceptor->sendMessageToAllExceptOne(exceptOne, std::move(message));
+    }
+
+    return;
+}
+
+void Server::sendMessageToAllExcept (std::vector<boost::asio::ip::address> exceptArray, std::string message)
+{
+    BOOST_LOG_TRIVIAL(info) << "TCP Server : send message = " << message;
+
+    if (const auto currentAcceptor = this->acceptor.load(); currentAcceptor != nullptr)
+    {
+        currentAcceptor->sendMessageToAllExcept(std::move(exceptArray), std::move(message));
+    }
 
     return;
 }
@@ -73,18 +106,21 @@ void Server::sendMessage (std::vector<boost::asio::ip::address> destArray, std::
 {
     BOOST_LOG_TRIVIAL(info) << "TCP Server : send message = " << message;
 
-    this->acceptor->sendMessage(std::move(destArray), std::move(message));
+    if (const auto currentAcceptor = this->acceptor.load(); currentAcceptor != nullptr)
+    {
+        currentAcceptor->sendMessage(std::move(destArray), std::move(message));
+    }
 
     return;
 }
 
-void Server::receiveMessage (std::string message)
+void Server::receiveMessage (std::string_view message)
 {
     BOOST_LOG_TRIVIAL(info) << "TCP Server : receive message = " << message;
 
     if (this->config.processMessageCallback != nullptr)
     {
-        this->config.processMessageCallback(std::move(message));
+        this->config.processMessageCallback(message);
     }
     
     return;
@@ -106,17 +142,36 @@ boost::asio::awaitable<void> Server::restartAsync ()
 
     BOOST_LOG_TRIVIAL(info) << "TCP Server : restarting after " << timeoutS << " seconds";
 
+    // The failed acceptor is closed on its own strand and destroyed once its coroutines end,
+    // so its port is free before the next acceptor binds it
+    if (const auto failedAcceptor = this->acceptor.exchange(nullptr); failedAcceptor != nullptr)
+    {
+        failedAcceptor->close();
+    }
+
     this->timer.expires_from_now(boost::posix_time::seconds(timeoutS));
     co_await this->timer.async_wait(boost::asio::use_awaitable);
 
+    if (this->isStarted != true)
+    {
+        co_return;
+    }
+
     BOOST_LOG_TRIVIAL(info) << "TCP Server : restarting";
 
     Acceptor::Config acceptorConfig;
-    acceptorConfig.port                     = this->config.port;
-    acceptorConfig.processMessageCallback   = std::bind(&Server::receiveMessage, this, std::placeholders::_1);
-    acceptorConfig.processErrorCallback     = std::bind(&Server::processError, this);
+    acceptorConfig.port                         = this->config.port;
+    acceptorConfig.processMessageCallback       = std::bind(&Server::receiveMessage, this, std::placeholders::_1);
+    acceptorConfig.processErrorCallback         = std::bind(&Server::processError, this);
+    acceptorConfig.processConnectionCallback    = this->config.processConnectionCallback;
 
-    this->acceptor = std::make_unique<Acceptor>(acceptorConfig, this->ioContext);
+    auto newAcceptor = std::make_shared<ConcurrentAcceptor>(acceptorConfig, this->ioContext);
+    newAcceptor->start();
+
+    if (const auto oldAcceptor = this->acceptor.exchange(std::move(newAcceptor)); oldAcceptor != nullptr)
+    {
+        oldAcceptor->close();
+    }
 
     co_return;
 }
@@ -6,6 +6,10 @@
 #ifndef TCP_SERVER_HPP
 #define TCP_SERVER_HPP
 
+#include <atomic>
+#include <memory>
+#include <string_view>
+
 #include <boost/asio/deadline_timer.hpp>
 #include <boost/asio/ip/address.hpp>
 #include <boost/asio/awaitable.hpp>
@@ -20,7 +24,8 @@ namespace TCP
             struct Config
             {
                 unsigned short int port;
-                std::function<void(std::string)> processMessageCallback;
+                std::function<void(std::string_view)> processMessageCallback;
+                std::function<void(boost::asio::ip::address)> processConnectionCallback;
             };
 
         public:
@@ -38,10 +43,11 @@ namespace TCP
         public:
             void sendMessageToAll (std::string message);
             void sendMessageToAllExceptOne (boost::asio::ip::address exceptOne, std::string message);
+            void sendMessageToAllExcept (std::vector<boost::asio::ip::address> exceptArray, std::string message);
             void sendMessage (std::vector<boost::asio::ip::address> destArray, std::string message);
 
         private:
-            void receiveMessage (std::string message);
+            void receiveMessage (std::string_view message);
             void processError ();
 
         private:
@@ -54,7 +60,10 @@ namespace TCP
             boost::asio::io_context &ioContext;
 
         private:
-            std::unique_ptr<Acceptor> acceptor;
+            // The senders run on the connection strands and take their own reference,
+            // a replaced acceptor is closed and lives on until its coroutines end
+            std::atomic<std::shared_ptr<Acceptor>> acceptor;
+            std::atomic<bool> isStarted;
             boost::asio::deadline_timer timer;
     };
 }
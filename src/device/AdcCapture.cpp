@@ -0,0 +1,407 @@
+/************************************************************
+ *   Author : German Mundinger
+ *   Date   : 2024
+ ************************************************************/
+
+#include "AdcCapture.hpp"
+
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <stdexcept>
+#include <cerrno>
+#include <cstdio>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <boost/asio/deadline_timer.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/asio/redirect_error.hpp>
+#include <boost/log/trivial.hpp>
+
+
+#define DEVICE_PATH     "/sys/bus/iio/devices/iio:device0"
+#define BUFFER_PATH     "/dev/iio:device0"
+
+
+static void writeAttribute (const std::string &path, std::size_t value);
+
+
+AdcCapture::AdcCapture (AdcCapture::Config config, boost::asio::io_context &context)
+:
+    bufferDescriptor { context }
+{
+    this->config = std::move(config);
+
+    this->scanBytes         = 0U;
+    this->alignedScanBytes  = 0U;
+
+    this->isScanReady   = this->setupScan();
+    this->isBufferOn    = (this->isScanReady == true) && (this->startBuffered() == true);
+    this->retryTime     = std::chrono::steady_clock::now() + std::chrono::milliseconds(AdcCapture::RETRY_PERIOD_MS);
+
+    if (this->isBufferOn != true)
+    {
+        BOOST_LOG_TRIVIAL(warning) << "ADC capture : buffered capture is not available, fallback to raw reads";
+    }
+
+    return;
+}
+
+AdcCapture::~AdcCapture ()
+{
+    if (this->isBufferOn == true)
+    {
+        this->stopBuffered();
+    }
+
+    return;
+}
+
+
+// Both sensors may wait at once : the device returns whole scans only,
+// so every reader collects its own block, and only its own timeout fails it
+boost::asio::awaitable<std::size_t> AdcCapture::readAverageAsync (std::size_t channel)
+{
+    const auto itrChannel = std::ranges::find(this->config.channelArray, channel);
+
+    if (itrChannel == std::end(this->config.channelArray))
+    {
+        throw std::invalid_argument { "ADC channel is not captured" };
+    }
+
+    const std::size_t channelIndex = static_cast<std::size_t>(std::distance(std::begin(this->config.channelArray), itrChannel));
+
+    // A failed capture is started again once the retry period is over, a stalled device may recover
+    if ((this->isBufferOn != true) && (this->isScanReady == true) && (std::chrono::steady_clock::now() >= this->retryTime))
+    {
+        this->isBufferOn = this->startBuffered();
+        this->retryTime  = std::chrono::steady_clock::now() + std::chrono::milliseconds(AdcCapture::RETRY_PERIOD_MS);
+
+        if (this->isBufferOn == true)
+        {
+            BOOST_LOG_TRIVIAL(info) << "ADC capture : buffered capture is restarted";
+        }
+    }
+
+    if (this->isBufferOn == true)
+    {
+        try
+        {
+            const std::vector<std::size_t> averageArray = co_await this->readBufferedAsync();
+
+            co_return averageArray[channelIndex];
+        }
+
+        catch (const std::exception &exp)
+        {
+            BOOST_LOG_TRIVIAL(warning) << "ADC capture : buffered error = " << exp.what() << ", fallback to raw reads";
+        }
+
+        // The raw files are readable once the buffer is off, it is tried again after the retry period
+        if (this->isBufferOn == true)
+        {
+            this->stopBuffered();
+            this->retryTime = std::chrono::steady_clock::now() + std::chrono::milliseconds(AdcCapture::RETRY_PERIOD_MS);
+        }
+    }
+
+    co_return this->readRaw(channel);
+}
+
+bool AdcCapture::isBuffered () const noexcept
+{
+    return this->isBufferOn;
+}
+
+// Layout of a scan : the enabled channels by scan index, each aligned to its storage size
+bool AdcCapture::setupScan ()
+{
+    const std::string scanPath = std::string { DEVICE_PATH } + "/scan_elements";
+
+    if (std::filesystem::exists(scanPath) != true)
+    {
+        return false;
+    }
+
+    std::vector<std::pair<std::size_t, ScanElement>> indexArray;
+
+    for (auto itr = std::cbegin(this->config.channelArray); itr != std::cend(this->config.channelArray); ++itr)
+    {
+        const std::string elementPath = scanPath + "/in_voltage" + std::to_string(*itr);
+
+        std::size_t index;
+        std::string type;
+
+        {
+            std::ifstream dataStream { elementPath + "_index" };
+            dataStream >> index;
+
+            if (dataStream.fail() == true)
+            {
+                return false;
+            }
+        }
+
+        {
+            std::ifstream dataStream { elementPath + "_type" };
+            dataStream >> type;
+
+            if (dataStream.fail() == true)
+            {
+                return false;
+            }
+        }
+
+        // Such as "le:u12/16>>0"
+        char endianness[3] = {};
+        char sign;
+        unsigned int realBits;
+        unsigned int storageBits;
+        unsigned int shift;
+
+        if (std::sscanf(type.c_str(), "%2c:%c%u/%u>>%u", endianness, &sign, &realBits, &storageBits, &shift) != 5)
+        {
+            return false;
+        }
+
+        if (((storageBits != 8U) && (storageBits != 16U) && (storageBits != 32U)) || (realBits > storageBits) || (realBits == 0U))
+        {
+            return false;
+        }
+
+        ScanElement element;
+        element.channel         = *itr;
+        element.offset          = 0U;
+        element.storageBytes    = storageBits / 8U;
+        element.shift           = shift;
+        element.mask            = (realBits == 32U) ? 0xFFFFFFFFU : ((1U << realBits) - 1U);
+        element.isBigEndian     = (endianness[0] == 'b');
+
+        indexArray.emplace_back(index, element);
+    }
+
+    std::ranges::sort(indexArray, {}, &std::pair<std::size_t, ScanElement>::first);
+
+    this->scanArray.clear();
+
+    for (auto itr = std::begin(indexArray); itr != std::end(indexArray); ++itr)
+    {
+        ScanElement &element = itr->second;
+
+        this->scanBytes = (this->scanBytes + element.storageBytes - 1U) / element.storageBytes * element.storageBytes;
+        element.offset  = this->scanBytes;
+
+        this->scanBytes += element.storageBytes;
+
+        this->scanArray.push_back(element);
+    }
+
+    if (this->scanBytes == 0U)
+    {
+        return false;
+    }
+
+    // Consecutive scans are aligned to the largest element
+    const std::size_t maxStorageBytes = std::ranges::max(this->scanArray, {}, &ScanElement::storageBytes).storageBytes;
+    this->alignedScanBytes = (this->scanBytes + maxStorageBytes - 1U) / maxStorageBytes * maxStorageBytes;
+
+    return true;
+}
+
+// The buffer runs for the lifetime of the capture, every read only waits for its scans
+bool AdcCapture::startBuffered ()
+{
+    const std::string devicePath = DEVICE_PATH;
+
+    try
+    {
+        writeAttribute(devicePath + "/buffer/enable", 0U);
+
+        for (auto itr = std::cbegin(this->scanArray); itr != std::cend(this->scanArray); ++itr)
+        {
+            writeAttribute(devicePath + "/scan_elements/in_voltage" + std::to_string(itr->channel) + "_en", 1U);
+        }
+
+        writeAttribute(devicePath + "/buffer/length", this->config.blockSize);
+        writeAttribute(devicePath + "/buffer/enable", 1U);
+    }
+
+    catch (const std::exception &exp)
+    {
+        BOOST_LOG_TRIVIAL(warning) << "ADC capture : buffer setup error = " << exp.what();
+
+        this->stopBuffered();
+
+        return false;
+    }
+
+    const int fileDescriptor = open(BUFFER_PATH, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+
+    if (fileDescriptor < 0)
+    {
+        this->stopBuffered();
+
+        return false;
+    }
+
+    this->bufferDescriptor.assign(fileDescriptor);
+
+    return true;
+}
+
+// Errors are ignored, it also cleans up after a failed capture
+void AdcCapture::stopBuffered () noexcept
+{
+    this->isBufferOn = false;
+
+    boost::system::error_code error;
+    this->bufferDescriptor.close(error);
+
+    const std::string devicePath = DEVICE_PATH;
+
+    {
+        std::ofstream dataStream { devicePath + "/buffer/enable" };
+        dataStream << 0U;
+    }
+
+    for (auto itr = std::cbegin(this->scanArray); itr != std::cend(this->scanArray); ++itr)
+    {
+        std::ofstream dataStream { devicePath + "/scan_elements/in_voltage" + std::to_string(itr->channel) + "_en" };
+        dataStream << 0U;
+    }
+
+    return;
+}
+
+boost::asio::awaitable<std::vector<std::size_t>> AdcCapture::readBufferedAsync ()
+{
+    std::vector<std::uint8_t> buffer(this->alignedScanBytes * this->config.blockSize);
+    std::size_t bufferSize = 0U;
+
+    // The scans queued while nobody was reading are stale, the buffer holds a block at most, so one read drops them
+    [[maybe_unused]] const ssize_t staleBytes = read(this->bufferDescriptor.native_handle(), buffer.data(), std::size(buffer));
+
+    // The descriptor is shared, a timeout cancels the waits of every reader : the state of each wait tells
+    // whether its own timer fired, and a timer handler queued before its cancel finds the wait already over
+    struct WaitState
+    {
+        bool isWaiting  = true;
+        bool isTimedOut = false;
+    };
+
+    boost::asio::deadline_timer timeoutTimer { this->bufferDescriptor.get_executor() };
+
+    while (bufferSize < std::size(buffer))
+    {
+        const auto waitState = std::make_shared<WaitState>();
+
+        timeoutTimer.expires_from_now(boost::posix_time::milliseconds(AdcCapture::READ_TIMEOUT_MS));
+        timeoutTimer.async_wait([this, waitState] (const boost::system::error_code &error)
+        {
+            if ((error != boost::asio::error::operation_aborted) && (waitState->isWaiting == true))
+            {
+                waitState->isTimedOut = true;
+
+                boost::system::error_code cancelError;
+                this->bufferDescriptor.cancel(cancelError);
+            }
+        });
+
+        boost::system::error_code waitError;
+        co_await this->bufferDescriptor.async_wait(boost::asio::posix::stream_descriptor::wait_read, boost::asio::redirect_error(boost::asio::use_awaitable, waitError));
+
+        waitState->isWaiting = false;
+        timeoutTimer.cancel();
+
+        if (waitState->isTimedOut == true)
+        {
+            throw std::runtime_error { "Buffer read timeout" };
+        }
+
+        if (waitError == boost::asio::error::operation_aborted)
+        {
+            // Another reader timed out or stopped the capture, this one waits again while the buffer runs
+            if (this->isBufferOn != true)
+            {
+                throw std::runtime_error { "Buffered capture is stopped" };
+            }
+
+            continue;
+        }
+
+        if (waitError.failed() == true)
+        {
+            throw boost::system::system_error { waitError };
+        }
+
+        const ssize_t bytes = read(this->bufferDescriptor.native_handle(), buffer.data() + bufferSize, std::size(buffer) - bufferSize);
+
+        if (bytes > 0)
+        {
+            bufferSize += static_cast<std::size_t>(bytes);
+        }
+        else if ((bytes == 0) || (errno != EAGAIN))
+        {
+            throw std::runtime_error { "Buffer read error" };
+        }
+    }
+
+    const std::size_t scanCount = bufferSize / this->alignedScanBytes;
+
+    std::vector<std::size_t> averageArray(std::size(this->config.channelArray), 0U);
+
+    for (auto itr = std::cbegin(this->scanArray); itr != std::cend(this->scanArray); ++itr)
+    {
+        std::size_t sum = 0U;
+
+        for (std::size_t scan = 0U; scan < scanCount; ++scan)
+        {
+            const std::uint8_t *data = buffer.data() + (scan * this->alignedScanBytes) + itr->offset;
+
+            std::uint32_t value = 0U;
+
+            for (std::size_t i = 0U; i < itr->storageBytes; ++i)
+            {
+                const std::size_t byte = (itr->isBigEndian == true) ? i : (itr->storageBytes - 1U - i);
+
+                value = (value << 8U) | data[byte];
+            }
+
+            sum += (value >> itr->shift) & itr->mask;
+        }
+
+        const auto itrChannel = std::ranges::find(this->config.channelArray, itr->channel);
+
+        averageArray[static_cast<std::size_t>(std::distance(std::begin(this->config.channelArray), itrChannel))] = sum / scanCount;
+    }
+
+    co_return averageArray;
+}
+
+std::size_t AdcCapture::readRaw (std::size_t channel) const
+{
+    const std::filesystem::path adcValuePath = std::string { DEVICE_PATH } + "/in_voltage" + std::to_string(channel) + "_raw";
+
+    std::ifstream dataStream;
+    dataStream.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+
+    std::size_t adcValue;
+    dataStream.open(adcValuePath, std::ios_base::in);
+    dataStream >> adcValue;
+
+    return adcValue;
+}
+
+
+void writeAttribute (const std::string &path, std::size_t value)
+{
+    std::ofstream dataStream;
+    dataStream.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+
+    dataStream.open(path, std::ios_base::out);
+    dataStream << value;
+
+    return;
+}
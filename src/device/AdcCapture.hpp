@@ -0,0 +1,78 @@
+/************************************************************
+ *   Author : German Mundinger
+ *   Date   : 2024
+ ************************************************************/
+
+#ifndef ADC_CAPTURE_H_
+#define ADC_CAPTURE_H_
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include <boost/asio/posix/stream_descriptor.hpp>
+#include <boost/asio/awaitable.hpp>
+
+class AdcCapture
+{
+    public:
+        static constexpr std::size_t DEFAULT_BLOCK_SIZE = 16U;
+        static constexpr long int READ_TIMEOUT_MS = 100;
+        static constexpr long int RETRY_PERIOD_MS = 10000;
+
+    public:
+        struct Config
+        {
+            std::vector<std::size_t> channelArray;  // Voltage channels of iio:device0, one capture serves all of them
+            std::size_t blockSize;                  // Scans per read
+        };
+
+    public:
+        explicit AdcCapture (Config config, boost::asio::io_context &context);
+        AdcCapture (const AdcCapture&) = delete;
+        AdcCapture& operator= (const AdcCapture&) = delete;
+        AdcCapture (AdcCapture&&) = delete;
+        AdcCapture& operator= (AdcCapture&&) = delete;
+        ~AdcCapture ();
+
+    public:
+        // Average of a fresh block for one of the configured channels
+        boost::asio::awaitable<std::size_t> readAverageAsync (std::size_t channel);
+        bool isBuffered () const noexcept;
+
+    private:
+        struct ScanElement
+        {
+            std::size_t channel;
+            std::size_t offset;         // Bytes from the start of a scan
+            std::size_t storageBytes;
+            std::size_t shift;
+            std::uint32_t mask;
+            bool isBigEndian;
+        };
+
+    private:
+        bool setupScan ();
+        bool startBuffered ();
+        void stopBuffered () noexcept;
+        boost::asio::awaitable<std::vector<std::size_t>> readBufferedAsync ();
+        std::size_t readRaw (std::size_t channel) const;
+
+    private:
+        Config config;
+
+    private:
+        bool isScanReady;
+        bool isBufferOn;
+        std::chrono::steady_clock::time_point retryTime;    // Buffered capture is started again from then on
+        std::size_t scanBytes;
+        std::size_t alignedScanBytes;
+        std::vector<ScanElement> scanArray;     // Sorted by scan index
+
+    private:
+        boost::asio::posix::stream_descriptor bufferDescriptor;
+};
+
+#endif // ADC_CAPTURE_H_
@@ -6,26 +6,71 @@
 #include "HdmiDisplay.hpp"
 
 #include <array>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
 
 #include <cairomm/cairomm.h>
 #include <pangomm.h>
 
 #include "frame_buffer.h"
+#include "frame_buffer_kernel.h"
 #include "std_error/std_error.h"
 
 
+static constexpr std::array<std::array<double, 3U>, HdmiDisplay::COLOR::COUNT> colors
+{{
+	{ 0.0, 0.0, 0.0 },	// Black : Red, Green, Blue
+	{ 1.0, 1.0, 1.0 },	// White
+	{ 1.0, 0.0, 0.0 },	// Red
+	{ 0.0, 1.0, 0.0 },	// Green
+	{ 0.0, 0.0, 1.0 },	// Blue
+	{ 0.5, 0.5, 0.5 }	// Gray
+}};
+
+
 HdmiDisplay::HdmiDisplay ()
 {
 	this->frameBuffer = std::make_unique<frame_buffer_t>();
+	this->isFrameBufferEnabled	= false;
+	this->isFrameBufferStale	= false;
+
+	this->width		= 0;
+	this->height	= 0;
+	this->stride	= 0;
+
+	this->pageCount		= 1U;
+	this->visiblePage	= 0U;
+
+	this->frameIndex	= 0U;
+	this->isFrameOpen	= false;
 
 	return;
 }
 
-HdmiDisplay::~HdmiDisplay () = default;
+HdmiDisplay::~HdmiDisplay ()
+{
+	if (this->isFrameBufferEnabled == true)
+	{
+		std_error_t error;
+		std_error_init(&error);
 
+		frame_buffer_close(this->frameBuffer.get(), &error);
+	}
 
+	return;
+}
+
+
+// The back buffer, its surface and context live in memory, they are kept while the resolution is the same
 void HdmiDisplay::enableFrameBuffer ()
 {
+	if (this->isFrameBufferEnabled == true)
+	{
+		return;
+	}
+
 	std_error_t error;
 	std_error_init(&error);
 
@@ -34,14 +79,59 @@ void HdmiDisplay::enableFrameBuffer ()
 		throw std::runtime_error { error.text };
 	}
 
+	this->isFrameBufferEnabled = true;
+
+	frame_buffer_data_t fb_data;
+	frame_buffer_get_data(this->frameBuffer.get(), &fb_data);
+
+	if ((fb_data.width != this->width) || (fb_data.height != this->height) || (!this->surface))
+	{
+		this->width		= fb_data.width;
+		this->height	= fb_data.height;
+		this->stride	= Cairo::ImageSurface::format_stride_for_width(Cairo::Surface::Format::RGB16_565, this->width);
+
+		this->context.reset();
+		this->surface.reset();
+
+		this->backBuffer.assign(static_cast<std::size_t>(this->stride) * static_cast<std::size_t>(this->height), 0U);
+
+		this->surface = Cairo::ImageSurface::create(this->backBuffer.data(),
+													Cairo::Surface::Format::RGB16_565,
+													this->width,
+													this->height,
+													this->stride);
+
+		this->context = Cairo::Context::create(this->surface);
+
+		this->shadowArray.clear();
+	}
+
+	const std::size_t pageCount = (fb_data.virtual_height >= (2 * fb_data.height)) ? 2U : 1U;
+
+	if (pageCount != this->pageCount)
+	{
+		this->pageCount = pageCount;
+		this->shadowArray.clear();
+	}
+
+	this->shadowArray.resize(this->pageCount);
+	this->visiblePage = std::min<std::size_t>(static_cast<std::size_t>(fb_data.y_offset / fb_data.height), this->pageCount - 1U);
+
 	return;
 }
 
 void HdmiDisplay::disableFrameBuffer ()
 {
+	if (this->isFrameBufferEnabled != true)
+	{
+		return;
+	}
+
 	std_error_t error;
 	std_error_init(&error);
 
+	this->isFrameBufferEnabled = false;
+
 	if (frame_buffer_close(this->frameBuffer.get(), &error) != STD_SUCCESS)
 	{
 		throw std::runtime_error { error.text };
@@ -50,92 +140,117 @@ void HdmiDisplay::disableFrameBuffer ()
 	return;
 }
 
-void HdmiDisplay::fillBackground (HdmiDisplay::COLOR color) const
+void HdmiDisplay::invalidateFrameBuffer ()
 {
-	std::array<std::array<double, 3U>, HdmiDisplay::COLOR::COUNT> colors;
-	colors[HdmiDisplay::COLOR::BLACK]	= { 0.0, 0.0, 0.0 }; // Red, Green, Blue
-	colors[HdmiDisplay::COLOR::WHITE]	= { 1.0, 1.0, 1.0 };
-	colors[HdmiDisplay::COLOR::RED]		= { 1.0, 0.0, 0.0 };
-	colors[HdmiDisplay::COLOR::GREEN]	= { 0.0, 1.0, 0.0 };
-	colors[HdmiDisplay::COLOR::BLUE]	= { 0.0, 0.0, 1.0 };
-	colors[HdmiDisplay::COLOR::GRAY]	= { 0.5, 0.5, 0.5 };
+	this->isFrameBufferStale = true;
 
-	frame_buffer_data_t fb_data;
-	frame_buffer_get_data(this->frameBuffer.get(), &fb_data);
+	return;
+}
 
-	const int stride = Cairo::ImageSurface::format_stride_for_width(Cairo::Surface::Format::RGB16_565, fb_data.width);
+HdmiDisplay::FrameGuard::FrameGuard (HdmiDisplay &display)
+:
+	display { display }
+{
+	return;
+}
 
-	auto surface = Cairo::ImageSurface::create(fb_data.buffer,
-												Cairo::Surface::Format::RGB16_565,
-												fb_data.width,
-												fb_data.height,
-												stride);
+HdmiDisplay::FrameGuard::~FrameGuard ()
+{
+	this->display.abortFrame();
 
-	auto context = Cairo::Context::create(surface);
+	return;
+}
 
-	context->set_source_rgb(colors[color][0], colors[color][1], colors[color][2]);
-	context->paint();
 
-	return;
+// A stale mapping is kept, unless the mode has changed or the device does not answer
+HdmiDisplay::FrameGuard HdmiDisplay::beginFrame ()
+{
+	this->abortFrame();
+
+	if ((this->isFrameBufferEnabled == true) && (this->isFrameBufferStale == true))
+	{
+		std_error_t error;
+		std_error_init(&error);
+
+		bool isChanged;
+
+		if ((frame_buffer_check(this->frameBuffer.get(), &isChanged, &error) != STD_SUCCESS) || (isChanged == true))
+		{
+			this->isFrameBufferEnabled = false;
+
+			frame_buffer_close(this->frameBuffer.get(), &error);
+
+			this->shadowArray.clear();
+		}
+	}
+
+	this->isFrameBufferStale = false;
+
+	this->enableFrameBuffer();
+
+	++this->frameIndex;
+
+	this->getContext()->save();
+	this->isFrameOpen = true;
+
+	return FrameGuard { *this };
 }
 
-void HdmiDisplay::drawText (HdmiDisplay::Text text) const
+// Layouts unused for a few frames are dropped, so the changing values do not pile up,
+// while a frame which draws no text, such as a blank one, keeps the others
+void HdmiDisplay::endFrame ()
 {
-	std::array<std::array<double, 3U>, HdmiDisplay::COLOR::COUNT> colors;
-	colors[HdmiDisplay::COLOR::BLACK]	= { 0.0, 0.0, 0.0 }; // Red, Green, Blue
-	colors[HdmiDisplay::COLOR::WHITE]	= { 1.0, 1.0, 1.0 };
-	colors[HdmiDisplay::COLOR::RED]		= { 1.0, 0.0, 0.0 };
-	colors[HdmiDisplay::COLOR::GREEN]	= { 0.0, 1.0, 0.0 };
-	colors[HdmiDisplay::COLOR::BLUE]	= { 0.0, 0.0, 1.0 };
-	colors[HdmiDisplay::COLOR::GRAY]	= { 0.5, 0.5, 0.5 };
+	if (this->isFrameOpen != true)
+	{
+		throw std::logic_error { "Frame is not begun" };
+	}
 
-	frame_buffer_data_t fb_data;
-	frame_buffer_get_data(this->frameBuffer.get(), &fb_data);
+	this->isFrameOpen = false;
 
-	const int stride = Cairo::ImageSurface::format_stride_for_width(Cairo::Surface::Format::RGB16_565, fb_data.width);
+	this->context->restore();
 
-	auto surface = Cairo::ImageSurface::create(fb_data.buffer,
-												Cairo::Surface::Format::RGB16_565,
-												fb_data.width,
-												fb_data.height,
-												stride);
+	this->surface->flush();
 
-	auto context = Cairo::Context::create(surface);
+	this->flushFrame();
 
-	context->move_to(text.x, text.y);
-	context->set_source_rgb(colors[text.color][0], colors[text.color][1], colors[text.color][2]);
+	std::erase_if(this->layoutCache, [this] (const auto &item) { return ((this->frameIndex - item.second.frameIndex) > HdmiDisplay::LAYOUT_MAX_AGE); });
 
-	auto layout = Pango::Layout::create(context);
+	return;
+}
+
+// The pixels are written directly, Cairo is only told about it
+void HdmiDisplay::fillBackground (HdmiDisplay::COLOR color)
+{
+	this->getContext();
+
+	const std::uint16_t pixel = frame_buffer_pack_rgb565(static_cast<std::uint8_t>(std::lround(colors[color][0] * 255.0)),
+															static_cast<std::uint8_t>(std::lround(colors[color][1] * 255.0)),
+															static_cast<std::uint8_t>(std::lround(colors[color][2] * 255.0)));
+
+	this->surface->flush();
 
-	layout->set_font_description(Pango::FontDescription { text.font });
-	layout->set_text(text.text);
-	layout->show_in_cairo_context(context);
+	frame_buffer_fill(this->backBuffer.data(), static_cast<std::size_t>(this->stride), static_cast<std::size_t>(this->width), static_cast<std::size_t>(this->height), pixel);
+
+	this->surface->mark_dirty();
 
 	return;
 }
 
-void HdmiDisplay::drawLine (HdmiDisplay::Line line) const
+void HdmiDisplay::drawText (HdmiDisplay::Text text)
 {
-	std::array<std::array<double, 3U>, HdmiDisplay::COLOR::COUNT> colors;
-	colors[HdmiDisplay::COLOR::BLACK]	= { 0.0, 0.0, 0.0 }; // Red, Green, Blue
-	colors[HdmiDisplay::COLOR::WHITE]	= { 1.0, 1.0, 1.0 };
-	colors[HdmiDisplay::COLOR::RED]		= { 1.0, 0.0, 0.0 };
-	colors[HdmiDisplay::COLOR::GREEN]	= { 0.0, 1.0, 0.0 };
-	colors[HdmiDisplay::COLOR::BLUE]	= { 0.0, 0.0, 1.0 };
-	colors[HdmiDisplay::COLOR::GRAY]	= { 0.5, 0.5, 0.5 };
+	const auto &context = this->getContext();
 
-	frame_buffer_data_t fb_data;
-	frame_buffer_get_data(this->frameBuffer.get(), &fb_data);
+	context->move_to(text.x, text.y);
+	context->set_source_rgb(colors[text.color][0], colors[text.color][1], colors[text.color][2]);
 
-	const int stride = Cairo::ImageSurface::format_stride_for_width(Cairo::Surface::Format::RGB16_565, fb_data.width);
+	this->getLayout(text.font, text.text)->show_in_cairo_context(context);
 
-	auto surface = Cairo::ImageSurface::create(fb_data.buffer,
-												Cairo::Surface::Format::RGB16_565,
-												fb_data.width,
-												fb_data.height,
-												stride);
+	return;
+}
 
-	auto context = Cairo::Context::create(surface);
+void HdmiDisplay::drawLine (HdmiDisplay::Line line)
+{
+	const auto &context = this->getContext();
 
 	context->move_to(line.x_0, line.y_0);
 	context->line_to(line.x_1, line.y_1);
@@ -146,25 +261,275 @@ void HdmiDisplay::drawLine (HdmiDisplay::Line line) const
 	return;
 }
 
-void HdmiDisplay::drawImage (HdmiDisplay::Image image) const
+void HdmiDisplay::drawImage (HdmiDisplay::Image image)
+{
+	const auto &context = this->getContext();
+
+	if (this->loadImage(image.file) != true)
+	{
+		throw std::runtime_error { "Image read error : " + image.file };
+	}
+
+	const auto &imageSurface = this->imageCache.at(image.file);
+
+	const auto format = imageSurface->get_format();
+
+	// On whole pixels the image is copied or blended by the kernels, clipped to the screen
+	if ((image.x == std::floor(image.x)) && (image.y == std::floor(image.y)) &&
+		((format == Cairo::Surface::Format::RGB16_565) || (format == Cairo::Surface::Format::ARGB32)))
+	{
+		const long imageX = std::lround(image.x);
+		const long imageY = std::lround(image.y);
+
+		const long left		= std::max(imageX, 0L);
+		const long top		= std::max(imageY, 0L);
+		const long right	= std::min(imageX + imageSurface->get_width(), static_cast<long>(this->width));
+		const long bottom	= std::min(imageY + imageSurface->get_height(), static_cast<long>(this->height));
+
+		if ((left >= right) || (top >= bottom))
+		{
+			return;
+		}
+
+		const std::size_t pixelSize		= (format == Cairo::Surface::Format::RGB16_565) ? sizeof(std::uint16_t) : sizeof(std::uint32_t);
+		const std::size_t imageStride	= static_cast<std::size_t>(imageSurface->get_stride());
+		const std::size_t targetStride	= static_cast<std::size_t>(this->stride);
+		const std::size_t blitWidth		= static_cast<std::size_t>(right - left);
+		const std::size_t blitHeight	= static_cast<std::size_t>(bottom - top);
+
+		const unsigned char *source = imageSurface->get_data() + (static_cast<std::size_t>(top - imageY) * imageStride) + (static_cast<std::size_t>(left - imageX) * pixelSize);
+		unsigned char *target = this->backBuffer.data() + (static_cast<std::size_t>(top) * targetStride) + (static_cast<std::size_t>(left) * sizeof(std::uint16_t));
+
+		this->surface->flush();
+
+		if (format == Cairo::Surface::Format::RGB16_565)
+		{
+			frame_buffer_copy(target, targetStride, source, imageStride, blitWidth, blitHeight);
+		}
+		else
+		{
+			frame_buffer_blend(target, targetStride, source, imageStride, blitWidth, blitHeight);
+		}
+
+		this->surface->mark_dirty(static_cast<int>(left), static_cast<int>(top), static_cast<int>(blitWidth), static_cast<int>(blitHeight));
+
+		return;
+	}
+
+	context->set_source(imageSurface, image.x, image.y);
+	context->rectangle(image.x, image.y, imageSurface->get_width(), imageSurface->get_height());
+	context->fill();
+
+	return;
+}
+
+// An opaque image is converted to the format of the back buffer, so it is copied as is.
+// An image with transparency keeps the premultiplied ARGB of the decoder to be blended
+bool HdmiDisplay::loadImage (const std::string &file)
+{
+	if (auto itr = this->imageCache.find(file); itr != std::end(this->imageCache))
+	{
+		return static_cast<bool>(itr->second);
+	}
+
+	Cairo::RefPtr<Cairo::ImageSurface> imageSurface;
+
+	try
+	{
+		auto pngSurface = Cairo::ImageSurface::create_from_png(file);
+
+		if (pngSurface->get_format() == Cairo::Surface::Format::RGB24)
+		{
+			imageSurface = Cairo::ImageSurface::create(Cairo::Surface::Format::RGB16_565, pngSurface->get_width(), pngSurface->get_height());
+
+			auto imageContext = Cairo::Context::create(imageSurface);
+			imageContext->set_source(pngSurface, 0.0, 0.0);
+			imageContext->paint();
+
+			imageSurface->flush();
+		}
+		else
+		{
+			imageSurface = std::move(pngSurface);
+		}
+	}
+
+	catch (const std::exception&)
+	{
+		imageSurface.reset();
+	}
+
+	this->imageCache.insert_or_assign(file, imageSurface);
+
+	return static_cast<bool>(imageSurface);
+}
+
+
+const Cairo::RefPtr<Cairo::Context>& HdmiDisplay::getContext () const
+{
+	if ((this->isFrameBufferEnabled != true) || (!this->context))
+	{
+		throw std::runtime_error { "Frame buffer is disabled" };
+	}
+
+	return this->context;
+}
+
+// A layout keeps its shaping, so the same text in the same font is laid out once
+const Glib::RefPtr<Pango::Layout>& HdmiDisplay::getLayout (const std::string &font, const std::string &text)
+{
+	auto itr = this->layoutCache.find(LayoutKey { font, text });
+
+	if (itr == std::end(this->layoutCache))
+	{
+		auto itrFont = this->fontCache.find(font);
+
+		if (itrFont == std::end(this->fontCache))
+		{
+			itrFont = this->fontCache.emplace(font, Pango::FontDescription { font }).first;
+		}
+
+		CachedLayout cachedLayout;
+		cachedLayout.layout		= Pango::Layout::create(this->getContext());
+		cachedLayout.frameIndex	= this->frameIndex;
+
+		cachedLayout.layout->set_font_description(itrFont->second);
+		cachedLayout.layout->set_text(text);
+
+		itr = this->layoutCache.emplace(LayoutKey { font, text }, std::move(cachedLayout)).first;
+	}
+
+	itr->second.frameIndex = this->frameIndex;
+
+	return itr->second.layout;
+}
+
+// The back buffer is compared with the last content of the page to draw, band by band,
+// and only the columns which differ within a band are copied. With two pages the hidden one
+// is updated and then shown, so a frame never appears half drawn
+void HdmiDisplay::flushFrame ()
 {
 	frame_buffer_data_t fb_data;
 	frame_buffer_get_data(this->frameBuffer.get(), &fb_data);
 
-	const int stride = Cairo::ImageSurface::format_stride_for_width(Cairo::Surface::Format::RGB16_565, fb_data.width);
+	const std::size_t page = (this->visiblePage + this->pageCount - 1U) % this->pageCount;
 
-	auto surface = Cairo::ImageSurface::create(fb_data.buffer,
-												Cairo::Surface::Format::RGB16_565,
-												fb_data.width,
-												fb_data.height,
-												stride);
+	const std::size_t rowStride	= static_cast<std::size_t>(this->stride);
+	const std::size_t rowBytes	= static_cast<std::size_t>(this->width) * 2U;
+	const std::size_t rowCount	= static_cast<std::size_t>(this->height);
 
-	auto imageSurface = Cairo::ImageSurface::create_from_png(image.file);
+	std::vector<unsigned char> &shadow = this->shadowArray[page];
+	const bool isShadowValid = (shadow.empty() != true);
 
-	auto context = Cairo::Context::create(surface);
-	context->set_source(imageSurface, image.x, image.y);
+	if (isShadowValid != true)
+	{
+		shadow.assign(std::size(this->backBuffer), 0U);
+	}
 
-	context->paint();
+	unsigned char *pageBuffer = fb_data.buffer + (page * rowCount * static_cast<std::size_t>(fb_data.line_length));
+
+	for (std::size_t bandRow = 0U; bandRow < rowCount; bandRow += HdmiDisplay::DIRTY_BAND_ROWS)
+	{
+		const std::size_t bandEnd = std::min(bandRow + HdmiDisplay::DIRTY_BAND_ROWS, rowCount);
+
+		std::size_t left	= rowBytes;
+		std::size_t right	= 0U;
+
+		for (std::size_t row = bandRow; row < bandEnd; ++row)
+		{
+			const unsigned char *source	= this->backBuffer.data() + (row * rowStride);
+			const unsigned char *target	= shadow.data() + (row * rowStride);
+
+			if (isShadowValid != true)
+			{
+				left	= 0U;
+				right	= rowBytes;
+
+				break;
+			}
+
+			if (std::memcmp(source, target, rowBytes) == 0)
+			{
+				continue;
+			}
+
+			std::size_t first = 0U;
+			while (source[first] == target[first])
+			{
+				++first;
+			}
+
+			std::size_t last = rowBytes;
+			while (source[last - 1U] == target[last - 1U])
+			{
+				--last;
+			}
+
+			left	= std::min(left, first);
+			right	= std::max(right, last);
+		}
+
+		if (left >= right)
+		{
+			continue;
+		}
+
+		// Whole pixels
+		left	= left & ~static_cast<std::size_t>(1U);
+		right	= (right + 1U) & ~static_cast<std::size_t>(1U);
+
+		for (std::size_t row = bandRow; row < bandEnd; ++row)
+		{
+			const unsigned char *source = this->backBuffer.data() + (row * rowStride) + left;
+
+			std::memcpy(pageBuffer + (row * static_cast<std::size_t>(fb_data.line_length)) + left, source, right - left);
+			std::memcpy(shadow.data() + (row * rowStride) + left, source, right - left);
+		}
+	}
+
+	if (this->pageCount > 1U)
+	{
+		std_error_t error;
+		std_error_init(&error);
+
+		if (frame_buffer_pan(this->frameBuffer.get(), static_cast<int>(page * rowCount), &error) == STD_SUCCESS)
+		{
+			this->visiblePage = page;
+		}
+		else
+		{
+			// The driver does not flip, the page is drawn in place from now on
+			this->pageCount		= 1U;
+			this->visiblePage	= 0U;
+
+			this->shadowArray.clear();
+			this->shadowArray.resize(this->pageCount);
+
+			this->flushFrame();
+		}
+	}
+
+	return;
+}
+
+// The frame is left without reaching the screen, such as on an error while it is drawn
+void HdmiDisplay::abortFrame () noexcept
+{
+	if (this->isFrameOpen != true)
+	{
+		return;
+	}
+
+	this->isFrameOpen = false;
+
+	try
+	{
+		this->context->restore();
+	}
+
+	catch (...)
+	{
+	}
 
 	return;
 }
@@ -6,13 +6,26 @@
 #ifndef HDMI_DISPLAY_H_
 #define HDMI_DISPLAY_H_
 
+#include <map>
+#include <vector>
 #include <string>
 #include <memory>
+#include <utility>
+#include <unordered_map>
+
+#include <cairomm/context.h>
+#include <cairomm/surface.h>
+#include <pangomm/layout.h>
+#include <pangomm/fontdescription.h>
 
 typedef struct frame_buffer frame_buffer_t;
 
 class HdmiDisplay
 {
+    private:
+        static constexpr std::size_t DIRTY_BAND_ROWS = 16U;    // Rows compared and copied as one rectangle
+        static constexpr std::size_t LAYOUT_MAX_AGE = 8U;      // Frames a layout is kept without being used
+
     public:
         enum COLOR : std::size_t
         {
@@ -47,6 +60,25 @@ class HdmiDisplay
             double x, y;
         };
 
+        // Restores the drawing state of a frame, which did not reach its end
+        class FrameGuard
+        {
+            public:
+                FrameGuard (const FrameGuard&) = delete;
+                FrameGuard& operator= (const FrameGuard&) = delete;
+                FrameGuard (FrameGuard&&) = delete;
+                FrameGuard& operator= (FrameGuard&&) = delete;
+                ~FrameGuard ();
+
+            private:
+                explicit FrameGuard (HdmiDisplay &display);
+
+            private:
+                HdmiDisplay &display;
+
+            friend class HdmiDisplay;
+        };
+
     public:
         explicit HdmiDisplay ();
         HdmiDisplay (const HdmiDisplay&) = delete;
@@ -56,16 +88,61 @@ class HdmiDisplay
         ~HdmiDisplay ();
 
     public:
+        // The mapping is kept between frames, the first frame maps it, if needed
         void enableFrameBuffer ();
         void disableFrameBuffer ();
+        void invalidateFrameBuffer ();
+
+        // The drawing calls of a frame go between them, the frame reaches the screen at its end
+        [[nodiscard]] FrameGuard beginFrame ();
+        void endFrame ();
+
+        void fillBackground (COLOR color);
+        void drawText (Text text);
+        void drawLine (Line line);
+        void drawImage (Image image);
+
+        // Decodes a file once, false if it can not be read (also remembered)
+        bool loadImage (const std::string &file);
 
-        void fillBackground (COLOR color) const;
-        void drawText (Text text) const;
-        void drawLine (Line line) const;
-        void drawImage (Image image) const;
+    private:
+        const Cairo::RefPtr<Cairo::Context>& getContext () const;
+        const Glib::RefPtr<Pango::Layout>& getLayout (const std::string &font, const std::string &text);
+        void flushFrame ();
+        void abortFrame () noexcept;
+
+    private:
+        struct CachedLayout
+        {
+            Glib::RefPtr<Pango::Layout> layout;
+            std::size_t frameIndex;     // Last frame which used it
+        };
+
+        using LayoutKey = std::pair<std::string, std::string>;  // Font, text
 
     private:
         std::unique_ptr<frame_buffer_t> frameBuffer;
+        bool isFrameBufferEnabled;
+        bool isFrameBufferStale;    // Checked before the next frame, such as after a power cycle
+
+    private:
+        int width, height;
+        int stride;
+        std::vector<unsigned char> backBuffer;  // RGB565, the frame is drawn here
+        Cairo::RefPtr<Cairo::ImageSurface> surface;
+        Cairo::RefPtr<Cairo::Context> context;
+
+    private:
+        std::size_t pageCount;      // Two, if the virtual resolution allows to flip
+        std::size_t visiblePage;
+        std::vector<std::vector<unsigned char>> shadowArray;   // Last content of each page, empty if unknown
+
+    private:
+        std::size_t frameIndex;
+        bool isFrameOpen;           // The context is saved by the frame
+        std::unordered_map<std::string, Pango::FontDescription> fontCache;
+        std::map<LayoutKey, CachedLayout> layoutCache;
+        std::unordered_map<std::string, Cairo::RefPtr<Cairo::ImageSurface>> imageCache;   // Empty if unreadable
 
 };
 
@@ -5,24 +5,21 @@
 
 #include "SmokeSensor.hpp"
 
-#include <fstream>
-#include <filesystem>
+#include "AdcCapture.hpp"
 
 
-SmokeSensor::SmokeSensor () = default;
-SmokeSensor::~SmokeSensor () = default;
-
-
-std::size_t SmokeSensor::readAdcValue () const
+SmokeSensor::SmokeSensor (std::shared_ptr<AdcCapture> capture)
 {
-    const std::filesystem::path adcValuePath = "/sys/bus/iio/devices/iio:device0/in_voltage3_raw";
+    this->adcCapture = std::move(capture);
 
-    std::ifstream dataStream;
-    dataStream.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+    return;
+}
+
+SmokeSensor::~SmokeSensor () = default;
 
-    std::size_t adcValue;
-    dataStream.open(adcValuePath, std::ios_base::in);
-    dataStream >> adcValue;
 
-    return adcValue;
+// Average of a block of conversions, a single one without the buffered capture
+boost::asio::awaitable<std::size_t> SmokeSensor::readAdcValueAsync ()
+{
+    co_return co_await this->adcCapture->readAverageAsync(SmokeSensor::ADC_CHANNEL);
 }
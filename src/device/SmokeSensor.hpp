@@ -6,12 +6,21 @@
 #ifndef SMOKE_SENSOR_H_
 #define SMOKE_SENSOR_H_
 
+#include <memory>
+#include <utility>
 #include <cstddef>
 
+#include <boost/asio/awaitable.hpp>
+
+class AdcCapture;
+
 class SmokeSensor
 {
     public:
-        explicit SmokeSensor ();
+        static constexpr std::size_t ADC_CHANNEL = 3U;
+
+    public:
+        explicit SmokeSensor (std::shared_ptr<AdcCapture> capture);
         SmokeSensor (const SmokeSensor&) = delete;
         SmokeSensor& operator= (const SmokeSensor&) = delete;
         SmokeSensor (SmokeSensor&&) = delete;
@@ -19,7 +28,10 @@ class SmokeSensor
         ~SmokeSensor ();
 
     public:
-        std::size_t readAdcValue () const;
+        boost::asio::awaitable<std::size_t> readAdcValueAsync ();
+
+    private:
+        std::shared_ptr<AdcCapture> adcCapture;     // Shared by every ADC user, one read captures all their channels
 };
 
 #endif // SMOKE_SENSOR_H_
@@ -39,9 +39,10 @@ int frame_buffer_open (frame_buffer_t * const self, const char *frame_buffer_nam
         return STD_FAILURE;
     }
 
-    if (ioctl(self->file_descriptor, FBIOGET_VSCREENINFO, &self->var_info) != (-1))
+    if ((ioctl(self->file_descriptor, FBIOGET_VSCREENINFO, &self->var_info) != (-1)) && (ioctl(self->file_descriptor, FBIOGET_FSCREENINFO, &self->fix_info) != (-1)))
     {
-        self->buffer_size = self->var_info.xres * self->var_info.yres * self->var_info.bits_per_pixel / 8U;
+        // The whole virtual resolution is mapped, so the pages off the screen can be drawn too
+        self->buffer_size = self->fix_info.line_length * self->var_info.yres_virtual;
         
         self->buffer = (unsigned char*)mmap(NULL, self->buffer_size, PROT_READ | PROT_WRITE, MAP_SHARED, self->file_descriptor, 0);
 
@@ -94,10 +95,57 @@ void frame_buffer_get_data (frame_buffer_t const * const self, frame_buffer_data
     assert(self != NULL);
     assert(data != NULL);
 
-    data->width     = (int)self->var_info.xres;
-    data->height    = (int)self->var_info.yres;
+    data->width             = (int)self->var_info.xres;
+    data->height            = (int)self->var_info.yres;
+    data->virtual_height    = (int)self->var_info.yres_virtual;
+    data->line_length       = (int)self->fix_info.line_length;
+    data->y_offset          = (int)self->var_info.yoffset;
 
     data->buffer = self->buffer;
 
     return;
 }
+
+int frame_buffer_pan (frame_buffer_t * const self, int y_offset, std_error_t * const error)
+{
+    assert(self != NULL);
+    assert(y_offset >= 0);
+
+    struct fb_var_screeninfo var_info = self->var_info;
+    var_info.xoffset = 0U;
+    var_info.yoffset = (__u32)y_offset;
+
+    if (ioctl(self->file_descriptor, FBIOPAN_DISPLAY, &var_info) == (-1))
+    {
+        std_error_catch_errno(error, __FILE__, __LINE__);
+
+        return STD_FAILURE;
+    }
+
+    self->var_info.yoffset = var_info.yoffset;
+
+    return STD_SUCCESS;
+}
+
+// The mode may change while the display is powered off, the mapping is valid for the same one only
+int frame_buffer_check (frame_buffer_t const * const self, bool * const is_changed, std_error_t * const error)
+{
+    assert(self != NULL);
+    assert(is_changed != NULL);
+
+    struct fb_var_screeninfo var_info;
+
+    if (ioctl(self->file_descriptor, FBIOGET_VSCREENINFO, &var_info) == (-1))
+    {
+        std_error_catch_errno(error, __FILE__, __LINE__);
+
+        return STD_FAILURE;
+    }
+
+    *is_changed = (var_info.xres != self->var_info.xres) ||
+                    (var_info.yres != self->var_info.yres) ||
+                    (var_info.yres_virtual != self->var_info.yres_virtual) ||
+                    (var_info.bits_per_pixel != self->var_info.bits_per_pixel);
+
+    return STD_SUCCESS;
+}
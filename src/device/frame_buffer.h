@@ -7,6 +7,7 @@
 #define FRAME_BUFFER_H_
 
 #include <stddef.h>
+#include <stdbool.h>
 
 typedef struct frame_buffer frame_buffer_t;
 typedef struct std_error std_error_t;
@@ -14,7 +15,10 @@ typedef struct std_error std_error_t;
 typedef struct frame_buffer_data
 {
     int width, height;
-    unsigned char *buffer;
+    int virtual_height;     // Pages of the height fit for panning
+    int line_length;        // Bytes per line
+    int y_offset;           // First line on the screen
+    unsigned char *buffer;  // Whole virtual resolution
 
 } frame_buffer_data_t;
 
@@ -26,6 +30,8 @@ int frame_buffer_open (frame_buffer_t * const self, const char *frame_buffer_nam
 int frame_buffer_close (frame_buffer_t * const self, std_error_t * const error);
 
 void frame_buffer_get_data (frame_buffer_t const * const self, frame_buffer_data_t * const data);
+int frame_buffer_pan (frame_buffer_t * const self, int y_offset, std_error_t * const error);
+int frame_buffer_check (frame_buffer_t const * const self, bool * const is_changed, std_error_t * const error);
 
 #ifdef __cplusplus
 }
@@ -41,6 +47,7 @@ typedef struct frame_buffer
     int file_descriptor;
 
     struct fb_var_screeninfo var_info;
+    struct fb_fix_screeninfo fix_info;
 
     unsigned char *buffer;
     size_t buffer_size;
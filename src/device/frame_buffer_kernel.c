@@ -0,0 +1,522 @@
+/************************************************************
+ *   Author : German Mundinger
+ *   Date   : 2024
+ ************************************************************/
+
+#include "frame_buffer_kernel.h"
+
+#include <string.h>
+#include <assert.h>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define FRAME_BUFFER_NEON
+#include <arm_neon.h>
+#elif defined(FRAME_BUFFER_REQUIRE_NEON)
+#error "NEON is not enabled, such as by -mfpu=neon"
+#elif defined(__SSE2__)
+#define FRAME_BUFFER_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__)
+#define FRAME_BUFFER_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
+
+typedef void (*fill_row_t) (uint16_t *target, size_t width, uint16_t color);
+typedef void (*blend_row_t) (uint16_t *target, uint32_t const *source, size_t width);
+
+static frame_buffer_kernel_t forced_kernel = FRAME_BUFFER_KERNEL_AUTO;
+
+
+static bool is_kernel_available (frame_buffer_kernel_t kernel);
+static frame_buffer_kernel_t get_kernel (void);
+
+static void fill_row_scalar (uint16_t *target, size_t width, uint16_t color);
+static void blend_row_scalar (uint16_t *target, uint32_t const *source, size_t width);
+
+#if defined(FRAME_BUFFER_NEON)
+static void fill_row_neon (uint16_t *target, size_t width, uint16_t color);
+static void blend_row_neon (uint16_t *target, uint32_t const *source, size_t width);
+#endif
+
+#if defined(FRAME_BUFFER_SSE2)
+static void fill_row_sse2 (uint16_t *target, size_t width, uint16_t color);
+static void blend_row_sse2 (uint16_t *target, uint32_t const *source, size_t width);
+#endif
+
+#if defined(FRAME_BUFFER_AVX2)
+static int is_avx2_supported (void);
+static void fill_row_avx2 (uint16_t *target, size_t width, uint16_t color);
+static void blend_row_avx2 (uint16_t *target, uint32_t const *source, size_t width);
+#endif
+
+
+uint16_t frame_buffer_pack_rgb565 (uint8_t red, uint8_t green, uint8_t blue)
+{
+    return (uint16_t)(((red >> 3U) << 11U) | ((green >> 2U) << 5U) | (blue >> 3U));
+}
+
+const char* frame_buffer_kernel_name (void)
+{
+    switch (get_kernel())
+    {
+        case FRAME_BUFFER_KERNEL_NEON:
+            return "neon";
+
+        case FRAME_BUFFER_KERNEL_AVX2:
+            return "avx2";
+
+        case FRAME_BUFFER_KERNEL_SSE2:
+            return "sse2";
+
+        default:
+            return "scalar";
+    }
+}
+
+bool frame_buffer_kernel_force (frame_buffer_kernel_t kernel)
+{
+    if (is_kernel_available(kernel) != true)
+    {
+        return false;
+    }
+
+    forced_kernel = kernel;
+
+    return true;
+}
+
+void frame_buffer_fill (uint8_t * const target, size_t target_stride, size_t width, size_t height, uint16_t color)
+{
+    assert(target != NULL);
+
+    fill_row_t fill_row;
+
+    switch (get_kernel())
+    {
+#if defined(FRAME_BUFFER_NEON)
+        case FRAME_BUFFER_KERNEL_NEON:
+            fill_row = fill_row_neon;
+            break;
+#endif
+#if defined(FRAME_BUFFER_AVX2)
+        case FRAME_BUFFER_KERNEL_AVX2:
+            fill_row = fill_row_avx2;
+            break;
+#endif
+#if defined(FRAME_BUFFER_SSE2)
+        case FRAME_BUFFER_KERNEL_SSE2:
+            fill_row = fill_row_sse2;
+            break;
+#endif
+        default:
+            fill_row = fill_row_scalar;
+            break;
+    }
+
+    for (size_t row = 0U; row < height; ++row)
+    {
+        fill_row((uint16_t*)(target + (row * target_stride)), width, color);
+    }
+
+    return;
+}
+
+// The C library copy is already vectorized for the target
+void frame_buffer_copy (uint8_t * const target, size_t target_stride, uint8_t const * const source, size_t source_stride, size_t width, size_t height)
+{
+    assert(target != NULL);
+    assert(source != NULL);
+
+    for (size_t row = 0U; row < height; ++row)
+    {
+        memcpy(target + (row * target_stride), source + (row * source_stride), width * sizeof(uint16_t));
+    }
+
+    return;
+}
+
+void frame_buffer_blend (uint8_t * const target, size_t target_stride, uint8_t const * const source, size_t source_stride, size_t width, size_t height)
+{
+    assert(target != NULL);
+    assert(source != NULL);
+
+    blend_row_t blend_row;
+
+    switch (get_kernel())
+    {
+#if defined(FRAME_BUFFER_NEON)
+        case FRAME_BUFFER_KERNEL_NEON:
+            blend_row = blend_row_neon;
+            break;
+#endif
+#if defined(FRAME_BUFFER_AVX2)
+        case FRAME_BUFFER_KERNEL_AVX2:
+            blend_row = blend_row_avx2;
+            break;
+#endif
+#if defined(FRAME_BUFFER_SSE2)
+        case FRAME_BUFFER_KERNEL_SSE2:
+            blend_row = blend_row_sse2;
+            break;
+#endif
+        default:
+            blend_row = blend_row_scalar;
+            break;
+    }
+
+    for (size_t row = 0U; row < height; ++row)
+    {
+        blend_row((uint16_t*)(target + (row * target_stride)), (uint32_t const*)(source + (row * source_stride)), width);
+    }
+
+    return;
+}
+
+void frame_buffer_fill_scalar (uint8_t * const target, size_t target_stride, size_t width, size_t height, uint16_t color)
+{
+    assert(target != NULL);
+
+    for (size_t row = 0U; row < height; ++row)
+    {
+        fill_row_scalar((uint16_t*)(target + (row * target_stride)), width, color);
+    }
+
+    return;
+}
+
+void frame_buffer_blend_scalar (uint8_t * const target, size_t target_stride, uint8_t const * const source, size_t source_stride, size_t width, size_t height)
+{
+    assert(target != NULL);
+    assert(source != NULL);
+
+    for (size_t row = 0U; row < height; ++row)
+    {
+        blend_row_scalar((uint16_t*)(target + (row * target_stride)), (uint32_t const*)(source + (row * source_stride)), width);
+    }
+
+    return;
+}
+
+
+bool is_kernel_available (frame_buffer_kernel_t kernel)
+{
+    switch (kernel)
+    {
+        case FRAME_BUFFER_KERNEL_AUTO:
+        case FRAME_BUFFER_KERNEL_SCALAR:
+            return true;
+
+#if defined(FRAME_BUFFER_NEON)
+        case FRAME_BUFFER_KERNEL_NEON:
+            return true;
+#endif
+
+#if defined(FRAME_BUFFER_SSE2)
+        case FRAME_BUFFER_KERNEL_SSE2:
+            return true;
+#endif
+
+#if defined(FRAME_BUFFER_AVX2)
+        case FRAME_BUFFER_KERNEL_AVX2:
+            return (is_avx2_supported() != 0);
+#endif
+
+        default:
+            return false;
+    }
+}
+
+frame_buffer_kernel_t get_kernel (void)
+{
+    if (forced_kernel != FRAME_BUFFER_KERNEL_AUTO)
+    {
+        return forced_kernel;
+    }
+
+#if defined(FRAME_BUFFER_NEON)
+    return FRAME_BUFFER_KERNEL_NEON;
+#else
+#if defined(FRAME_BUFFER_AVX2)
+    if (is_avx2_supported() != 0)
+    {
+        return FRAME_BUFFER_KERNEL_AVX2;
+    }
+#endif
+#if defined(FRAME_BUFFER_SSE2)
+    return FRAME_BUFFER_KERNEL_SSE2;
+#else
+    return FRAME_BUFFER_KERNEL_SCALAR;
+#endif
+#endif
+}
+
+
+void fill_row_scalar (uint16_t *target, size_t width, uint16_t color)
+{
+    for (size_t i = 0U; i < width; ++i)
+    {
+        target[i] = color;
+    }
+
+    return;
+}
+
+// Per channel : source + target * (255 - alpha) / 255, the division is exact with rounding
+void blend_row_scalar (uint16_t *target, uint32_t const *source, size_t width)
+{
+    for (size_t i = 0U; i < width; ++i)
+    {
+        const uint32_t pixel = source[i];
+        const uint32_t alpha = pixel >> 24U;
+
+        if (alpha == 0xFFU)
+        {
+            target[i] = frame_buffer_pack_rgb565((uint8_t)(pixel >> 16U), (uint8_t)(pixel >> 8U), (uint8_t)pixel);
+
+            continue;
+        }
+
+        const uint32_t color = target[i];
+        const uint32_t inverse = 255U - alpha;
+
+        const uint32_t red_5    = (color >> 11U) & 0x1FU;
+        const uint32_t green_6  = (color >> 5U) & 0x3FU;
+        const uint32_t blue_5   = color & 0x1FU;
+
+        uint32_t red    = ((red_5 << 3U) | (red_5 >> 2U)) * inverse;
+        uint32_t green  = ((green_6 << 2U) | (green_6 >> 4U)) * inverse;
+        uint32_t blue   = ((blue_5 << 3U) | (blue_5 >> 2U)) * inverse;
+
+        red     = ((red + 128U + ((red + 128U) >> 8U)) >> 8U) + ((pixel >> 16U) & 0xFFU);
+        green   = ((green + 128U + ((green + 128U) >> 8U)) >> 8U) + ((pixel >> 8U) & 0xFFU);
+        blue    = ((blue + 128U + ((blue + 128U) >> 8U)) >> 8U) + (pixel & 0xFFU);
+
+        red     = (red > 255U) ? 255U : red;
+        green   = (green > 255U) ? 255U : green;
+        blue    = (blue > 255U) ? 255U : blue;
+
+        target[i] = frame_buffer_pack_rgb565((uint8_t)red, (uint8_t)green, (uint8_t)blue);
+    }
+
+    return;
+}
+
+
+#if defined(FRAME_BUFFER_NEON)
+
+void fill_row_neon (uint16_t *target, size_t width, uint16_t color)
+{
+    const uint16x8_t value = vdupq_n_u16(color);
+
+    size_t i = 0U;
+
+    for (; (i + 8U) <= width; i += 8U)
+    {
+        vst1q_u16(target + i, value);
+    }
+
+    fill_row_scalar(target + i, width - i, color);
+
+    return;
+}
+
+void blend_row_neon (uint16_t *target, uint32_t const *source, size_t width)
+{
+    size_t i = 0U;
+
+    for (; (i + 8U) <= width; i += 8U)
+    {
+        // Little endian ARGB32 : blue, green, red, alpha
+        const uint8x8x4_t pixel = vld4_u8((uint8_t const*)(source + i));
+        const uint16x8_t color = vld1q_u16(target + i);
+
+        const uint8x8_t inverse = vmvn_u8(pixel.val[3]);
+
+        const uint16x8_t red_5      = vshrq_n_u16(color, 11);
+        const uint16x8_t green_6    = vandq_u16(vshrq_n_u16(color, 5), vdupq_n_u16(0x3FU));
+        const uint16x8_t blue_5     = vandq_u16(color, vdupq_n_u16(0x1FU));
+
+        const uint8x8_t red_8   = vmovn_u16(vorrq_u16(vshlq_n_u16(red_5, 3), vshrq_n_u16(red_5, 2)));
+        const uint8x8_t green_8 = vmovn_u16(vorrq_u16(vshlq_n_u16(green_6, 2), vshrq_n_u16(green_6, 4)));
+        const uint8x8_t blue_8  = vmovn_u16(vorrq_u16(vshlq_n_u16(blue_5, 3), vshrq_n_u16(blue_5, 2)));
+
+        const uint16x8_t red_product    = vmull_u8(red_8, inverse);
+        const uint16x8_t green_product  = vmull_u8(green_8, inverse);
+        const uint16x8_t blue_product   = vmull_u8(blue_8, inverse);
+
+        const uint8x8_t red     = vqadd_u8(pixel.val[2], vraddhn_u16(red_product, vrshrq_n_u16(red_product, 8)));
+        const uint8x8_t green   = vqadd_u8(pixel.val[1], vraddhn_u16(green_product, vrshrq_n_u16(green_product, 8)));
+        const uint8x8_t blue    = vqadd_u8(pixel.val[0], vraddhn_u16(blue_product, vrshrq_n_u16(blue_product, 8)));
+
+        uint16x8_t result = vandq_u16(vshll_n_u8(red, 8), vdupq_n_u16(0xF800U));
+        result = vorrq_u16(result, vandq_u16(vshrq_n_u16(vshll_n_u8(green, 8), 5), vdupq_n_u16(0x07E0U)));
+        result = vorrq_u16(result, vmovl_u8(vshr_n_u8(blue, 3)));
+
+        vst1q_u16(target + i, result);
+    }
+
+    blend_row_scalar(target + i, source + i, width - i);
+
+    return;
+}
+
+#endif // FRAME_BUFFER_NEON
+
+
+#if defined(FRAME_BUFFER_SSE2)
+
+void fill_row_sse2 (uint16_t *target, size_t width, uint16_t color)
+{
+    const __m128i value = _mm_set1_epi16((short)color);
+
+    size_t i = 0U;
+
+    for (; (i + 8U) <= width; i += 8U)
+    {
+        _mm_storeu_si128((__m128i*)(target + i), value);
+    }
+
+    fill_row_scalar(target + i, width - i, color);
+
+    return;
+}
+
+void blend_row_sse2 (uint16_t *target, uint32_t const *source, size_t width)
+{
+    const __m128i mask_8    = _mm_set1_epi32(0xFF);
+    const __m128i max_8     = _mm_set1_epi16(0xFF);
+    const __m128i round     = _mm_set1_epi16(0x80);
+
+    size_t i = 0U;
+
+    for (; (i + 8U) <= width; i += 8U)
+    {
+        const __m128i pixel_0 = _mm_loadu_si128((__m128i const*)(source + i));
+        const __m128i pixel_1 = _mm_loadu_si128((__m128i const*)(source + i + 4U));
+        const __m128i color = _mm_loadu_si128((__m128i const*)(target + i));
+
+        // Channels of 8 pixels in 16 bit lanes
+        const __m128i blue  = _mm_packs_epi32(_mm_and_si128(pixel_0, mask_8), _mm_and_si128(pixel_1, mask_8));
+        const __m128i green = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(pixel_0, 8), mask_8), _mm_and_si128(_mm_srli_epi32(pixel_1, 8), mask_8));
+        const __m128i red   = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(pixel_0, 16), mask_8), _mm_and_si128(_mm_srli_epi32(pixel_1, 16), mask_8));
+        const __m128i alpha = _mm_packs_epi32(_mm_srli_epi32(pixel_0, 24), _mm_srli_epi32(pixel_1, 24));
+
+        const __m128i inverse = _mm_sub_epi16(max_8, alpha);
+
+        const __m128i red_5     = _mm_srli_epi16(color, 11);
+        const __m128i green_6   = _mm_and_si128(_mm_srli_epi16(color, 5), _mm_set1_epi16(0x3F));
+        const __m128i blue_5    = _mm_and_si128(color, _mm_set1_epi16(0x1F));
+
+        __m128i red_product     = _mm_mullo_epi16(_mm_or_si128(_mm_slli_epi16(red_5, 3), _mm_srli_epi16(red_5, 2)), inverse);
+        __m128i green_product   = _mm_mullo_epi16(_mm_or_si128(_mm_slli_epi16(green_6, 2), _mm_srli_epi16(green_6, 4)), inverse);
+        __m128i blue_product    = _mm_mullo_epi16(_mm_or_si128(_mm_slli_epi16(blue_5, 3), _mm_srli_epi16(blue_5, 2)), inverse);
+
+        red_product     = _mm_add_epi16(red_product, round);
+        green_product   = _mm_add_epi16(green_product, round);
+        blue_product    = _mm_add_epi16(blue_product, round);
+
+        red_product     = _mm_srli_epi16(_mm_add_epi16(red_product, _mm_srli_epi16(red_product, 8)), 8);
+        green_product   = _mm_srli_epi16(_mm_add_epi16(green_product, _mm_srli_epi16(green_product, 8)), 8);
+        blue_product    = _mm_srli_epi16(_mm_add_epi16(blue_product, _mm_srli_epi16(blue_product, 8)), 8);
+
+        const __m128i red_8     = _mm_min_epi16(_mm_add_epi16(red, red_product), max_8);
+        const __m128i green_8   = _mm_min_epi16(_mm_add_epi16(green, green_product), max_8);
+        const __m128i blue_8    = _mm_min_epi16(_mm_add_epi16(blue, blue_product), max_8);
+
+        __m128i result = _mm_slli_epi16(_mm_srli_epi16(red_8, 3), 11);
+        result = _mm_or_si128(result, _mm_slli_epi16(_mm_srli_epi16(green_8, 2), 5));
+        result = _mm_or_si128(result, _mm_srli_epi16(blue_8, 3));
+
+        _mm_storeu_si128((__m128i*)(target + i), result);
+    }
+
+    blend_row_scalar(target + i, source + i, width - i);
+
+    return;
+}
+
+#endif // FRAME_BUFFER_SSE2
+
+
+#if defined(FRAME_BUFFER_AVX2)
+
+int is_avx2_supported (void)
+{
+    return __builtin_cpu_supports("avx2");
+}
+
+__attribute__((target("avx2")))
+void fill_row_avx2 (uint16_t *target, size_t width, uint16_t color)
+{
+    const __m256i value = _mm256_set1_epi16((short)color);
+
+    size_t i = 0U;
+
+    for (; (i + 16U) <= width; i += 16U)
+    {
+        _mm256_storeu_si256((__m256i*)(target + i), value);
+    }
+
+    fill_row_scalar(target + i, width - i, color);
+
+    return;
+}
+
+__attribute__((target("avx2")))
+void blend_row_avx2 (uint16_t *target, uint32_t const *source, size_t width)
+{
+    const __m256i mask_8    = _mm256_set1_epi32(0xFF);
+    const __m256i max_8     = _mm256_set1_epi16(0xFF);
+    const __m256i round     = _mm256_set1_epi16(0x80);
+
+    size_t i = 0U;
+
+    for (; (i + 16U) <= width; i += 16U)
+    {
+        const __m256i pixel_0 = _mm256_loadu_si256((__m256i const*)(source + i));
+        const __m256i pixel_1 = _mm256_loadu_si256((__m256i const*)(source + i + 8U));
+        const __m256i color = _mm256_loadu_si256((__m256i const*)(target + i));
+
+        // The packing works per 128 bit lane, the permutation restores the pixel order
+        const __m256i blue  = _mm256_permute4x64_epi64(_mm256_packs_epi32(_mm256_and_si256(pixel_0, mask_8), _mm256_and_si256(pixel_1, mask_8)), 0xD8);
+        const __m256i green = _mm256_permute4x64_epi64(_mm256_packs_epi32(_mm256_and_si256(_mm256_srli_epi32(pixel_0, 8), mask_8), _mm256_and_si256(_mm256_srli_epi32(pixel_1, 8), mask_8)), 0xD8);
+        const __m256i red   = _mm256_permute4x64_epi64(_mm256_packs_epi32(_mm256_and_si256(_mm256_srli_epi32(pixel_0, 16), mask_8), _mm256_and_si256(_mm256_srli_epi32(pixel_1, 16), mask_8)), 0xD8);
+        const __m256i alpha = _mm256_permute4x64_epi64(_mm256_packs_epi32(_mm256_srli_epi32(pixel_0, 24), _mm256_srli_epi32(pixel_1, 24)), 0xD8);
+
+        const __m256i inverse = _mm256_sub_epi16(max_8, alpha);
+
+        const __m256i red_5     = _mm256_srli_epi16(color, 11);
+        const __m256i green_6   = _mm256_and_si256(_mm256_srli_epi16(color, 5), _mm256_set1_epi16(0x3F));
+        const __m256i blue_5    = _mm256_and_si256(color, _mm256_set1_epi16(0x1F));
+
+        __m256i red_product     = _mm256_mullo_epi16(_mm256_or_si256(_mm256_slli_epi16(red_5, 3), _mm256_srli_epi16(red_5, 2)), inverse);
+        __m256i green_product   = _mm256_mullo_epi16(_mm256_or_si256(_mm256_slli_epi16(green_6, 2), _mm256_srli_epi16(green_6, 4)), inverse);
+        __m256i blue_product    = _mm256_mullo_epi16(_mm256_or_si256(_mm256_slli_epi16(blue_5, 3), _mm256_srli_epi16(blue_5, 2)), inverse);
+
+        red_product     = _mm256_add_epi16(red_product, round);
+        green_product   = _mm256_add_epi16(green_product, round);
+        blue_product    = _mm256_add_epi16(blue_product, round);
+
+        red_product     = _mm256_srli_epi16(_mm256_add_epi16(red_product, _mm256_srli_epi16(red_product, 8)), 8);
+        green_product   = _mm256_srli_epi16(_mm256_add_epi16(green_product, _mm256_srli_epi16(green_product, 8)), 8);
+        blue_product    = _mm256_srli_epi16(_mm256_add_epi16(blue_product, _mm256_srli_epi16(blue_product, 8)), 8);
+
+        const __m256i red_8     = _mm256_min_epi16(_mm256_add_epi16(red, red_product), max_8);
+        const __m256i green_8   = _mm256_min_epi16(_mm256_add_epi16(green, green_product), max_8);
+        const __m256i blue_8    = _mm256_min_epi16(_mm256_add_epi16(blue, blue_product), max_8);
+
+        __m256i result = _mm256_slli_epi16(_mm256_srli_epi16(red_8, 3), 11);
+        result = _mm256_or_si256(result, _mm256_slli_epi16(_mm256_srli_epi16(green_8, 2), 5));
+        result = _mm256_or_si256(result, _mm256_srli_epi16(blue_8, 3));
+
+        _mm256_storeu_si256((__m256i*)(target + i), result);
+    }
+
+    blend_row_sse2(target + i, source + i, width - i);
+
+    return;
+}
+
+#endif // FRAME_BUFFER_AVX2
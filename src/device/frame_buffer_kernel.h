@@ -0,0 +1,51 @@
+/************************************************************
+ *   Author : German Mundinger
+ *   Date   : 2024
+ ************************************************************/
+
+#ifndef FRAME_BUFFER_KERNEL_H_
+#define FRAME_BUFFER_KERNEL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Pixel kernels for RGB565 buffers, the strides are in bytes.
+// The fastest path of the build is chosen : NEON, AVX2 (checked at run time), SSE2, scalar
+
+typedef enum frame_buffer_kernel
+{
+    FRAME_BUFFER_KERNEL_AUTO = 0,   // The fastest one
+    FRAME_BUFFER_KERNEL_SCALAR,
+    FRAME_BUFFER_KERNEL_SSE2,
+    FRAME_BUFFER_KERNEL_AVX2,
+    FRAME_BUFFER_KERNEL_NEON
+
+} frame_buffer_kernel_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint16_t frame_buffer_pack_rgb565 (uint8_t red, uint8_t green, uint8_t blue);
+const char* frame_buffer_kernel_name (void);
+
+// Forces the path of the next calls, for the tests and the benchmarks (not thread safe).
+// False if the build or the processor lacks it, the path is not changed then
+bool frame_buffer_kernel_force (frame_buffer_kernel_t kernel);
+
+void frame_buffer_fill (uint8_t * const target, size_t target_stride, size_t width, size_t height, uint16_t color);
+void frame_buffer_copy (uint8_t * const target, size_t target_stride, uint8_t const * const source, size_t source_stride, size_t width, size_t height);
+
+// The source is the premultiplied ARGB32 of Cairo
+void frame_buffer_blend (uint8_t * const target, size_t target_stride, uint8_t const * const source, size_t source_stride, size_t width, size_t height);
+
+// Reference paths, for the tests and the benchmarks
+void frame_buffer_fill_scalar (uint8_t * const target, size_t target_stride, size_t width, size_t height, uint16_t color);
+void frame_buffer_blend_scalar (uint8_t * const target, size_t target_stride, uint8_t const * const source, size_t source_stride, size_t width, size_t height);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FRAME_BUFFER_KERNEL_H_
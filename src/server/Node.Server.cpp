@@ -6,7 +6,8 @@
 #include "Node.Server.hpp"
 #include "Node.Mapper.hpp"
 
-#include <boost/asio/post.hpp>
+#include <algorithm>
+
 #include <boost/bind/bind.hpp>
 #include <boost/exception/diagnostic_information.hpp>
 #include <boost/log/trivial.hpp>
@@ -37,6 +38,8 @@ NodeServer::NodeServer (boost::asio::io_context &context)
     // Init TCP Server
     this->server = std::make_unique<TCP::Server>(context);
 
+    this->subscriptionIndex.store(std::make_shared<const SubscriptionIndex>());
+
     return;
 }
 
@@ -46,48 +49,102 @@ NodeServer::~NodeServer () = default;
 void NodeServer::start ()
 {
     TCP::Server::Config config;
-    config.port                     = static_cast<decltype(config.port)>(server_port);
-    config.processMessageCallback   = std::bind(&NodeServer::receiveMessage, this, std::placeholders::_1);
+    config.port                         = static_cast<decltype(config.port)>(server_port);
+    config.processMessageCallback       = std::bind(&NodeServer::receiveMessage, this, std::placeholders::_1);
+    config.processConnectionCallback    = std::bind(&NodeServer::processConnection, this, std::placeholders::_1);
 
     this->server->start(config);
 
     return;
 }
 
-void NodeServer::receiveMessage (std::string message)
+void NodeServer::receiveMessage (std::string_view message)
 {
-    auto asyncCallback = std::bind(&NodeServer::redirectMessage, this, std::move(message));
-    boost::asio::post(this->ioContext, asyncCallback);
+    // Redirect right away on the strand of the source connection, so its messages keep their order
+    this->redirectMessage(message);
 
     return;
 }
 
-void NodeServer::redirectMessage (std::string message)
+// Only the header is peeked, the original bytes are forwarded untouched
+void NodeServer::redirectMessage (std::string_view message)
 {
     NodeMsgHeader header;
+    std::uint32_t command;
+    node_command_id_t cmdID;
+
+    if (const auto error = deserializeRoute(message, header, command); error != NODE_MAPPER_ERROR::NONE)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Node Server : error = " << toString(error);
+
+        return;
+    }
+
+    // The header is not validated by the route peeking, it indexes the node table below
+    if ((header.source != NODE_BROADCAST) && (static_cast<std::size_t>(header.source) >= std::size(this->nodeTable)))
+    {
+        BOOST_LOG_TRIVIAL(error) << "Node Server : message of unknown node = " << header.source;
+
+        return;
+    }
 
-    try
+    if (command == NODE_SUBSCRIBE_CMD_ID)
     {
-        header = deserializeHeader(message);
+        this->processSubscription(message);
+
+        return;
     }
-    catch (const std::exception &exp)
+
+    if (const auto error = toNodeCommand(command, cmdID); error != NODE_MAPPER_ERROR::NONE)
     {
-        BOOST_LOG_TRIVIAL(error) << "Node Server : error = " << exp.what();
+        BOOST_LOG_TRIVIAL(error) << "Node Server : error = " << toString(error);
 
         return;
     }
 
+    std::unique_lock<std::mutex> cacheLock;
+
+    if (std::find(std::cbegin(NodeServer::CACHED_COMMAND_ARRAY), std::cend(NodeServer::CACHED_COMMAND_ARRAY), cmdID) != std::cend(NodeServer::CACHED_COMMAND_ARRAY))
+    {
+        cacheLock = std::unique_lock<std::mutex> { this->cacheMutex };
+
+        CachedMessage cachedMessage;
+        cachedMessage.destArray = header.destArray;
+        cachedMessage.message   = message;
+
+        this->cache.insert_or_assign(CacheKey { header.source, cmdID }, std::move(cachedMessage));
+    }
+
     if (header.destArray.contains(NODE_BROADCAST) == true)
     {
-		if (header.source != NODE_BROADCAST)
-		{
-			auto ip = this->nodeTable[header.source];
-        	this->server->sendMessageToAllExceptOne(ip, std::move(message));
-		}
-		else
-		{
-			this->server->sendMessageToAll(std::move(message));
-		}
+        const auto subscription = this->subscriptionIndex.load();
+
+        if (subscription->nodeArray.empty() == true)
+        {
+            if (header.source != NODE_BROADCAST)
+            {
+                auto ip = this->nodeTable[header.source];
+                this->server->sendMessageToAllExceptOne(ip, std::string { message });
+            }
+            else
+            {
+                this->server->sendMessageToAll(std::string { message });
+            }
+        }
+        else
+        {
+            // Subscribed nodes get the commands they consume only, the others get every broadcast
+            const auto itr = subscription->skipArray.find(cmdID);
+
+            std::vector<boost::asio::ip::address> exceptArray = (itr != std::cend(subscription->skipArray)) ? itr->second : subscription->defaultSkipArray;
+
+            if (header.source != NODE_BROADCAST)
+            {
+                exceptArray.push_back(this->nodeTable[header.source]);
+            }
+
+            this->server->sendMessageToAllExcept(std::move(exceptArray), std::string { message });
+        }
     }
     else
     {
@@ -96,12 +153,138 @@ void NodeServer::redirectMessage (std::string message)
 
         for (auto itr = std::cbegin(header.destArray); itr != std::cend(header.destArray); ++itr)
         {
+            if (static_cast<std::size_t>(*itr) >= std::size(this->nodeTable))
+            {
+                BOOST_LOG_TRIVIAL(error) << "Node Server : message to unknown node = " << *itr;
+
+                continue;
+            }
+
             auto ip = this->nodeTable[*itr];
             destArray.push_back(boost::move(ip));
         }
 
-        this->server->sendMessage(std::move(destArray), std::move(message));
+        this->server->sendMessage(std::move(destArray), std::string { message });
+    }
+
+    return;
+}
+
+// An empty command list cancels the subscription, the node gets every broadcast again
+void NodeServer::processSubscription (std::string_view message)
+{
+    NodeSubscription subscription;
+
+    if (const auto error = deserializeSubscription(message, subscription); error != NODE_MAPPER_ERROR::NONE)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Node Server : error = " << toString(error);
+
+        return;
+    }
+
+    if (static_cast<std::size_t>(subscription.source) >= std::size(this->nodeTable))
+    {
+        BOOST_LOG_TRIVIAL(error) << "Node Server : subscription of unknown node = " << subscription.source;
+
+        return;
+    }
+
+    BOOST_LOG_TRIVIAL(info) << "Node Server : node[" << subscription.source << "] subscription, command count = " << std::size(subscription.cmdArray);
+
+    std::scoped_lock lock { this->subscriptionMutex };
+
+    auto newIndex = std::make_shared<SubscriptionIndex>(*this->subscriptionIndex.load());
+
+    if (subscription.cmdArray.empty() == true)
+    {
+        newIndex->nodeArray.erase(subscription.source);
+    }
+    else
+    {
+        newIndex->nodeArray.insert_or_assign(subscription.source, std::move(subscription.cmdArray));
+    }
+
+    // Rebuild the per-command skip lists
+    newIndex->skipArray.clear();
+    newIndex->defaultSkipArray.clear();
+
+    for (auto itrNode = std::cbegin(newIndex->nodeArray); itrNode != std::cend(newIndex->nodeArray); ++itrNode)
+    {
+        for (auto itrCmd = std::cbegin(itrNode->second); itrCmd != std::cend(itrNode->second); ++itrCmd)
+        {
+            newIndex->skipArray.try_emplace(*itrCmd);
+        }
+    }
+
+    for (auto itrNode = std::cbegin(newIndex->nodeArray); itrNode != std::cend(newIndex->nodeArray); ++itrNode)
+    {
+        const auto &[node, nodeCmdArray] = *itrNode;
+        const auto &ip = this->nodeTable[node];
+
+        newIndex->defaultSkipArray.push_back(ip);
+
+        for (auto itrSkip = std::begin(newIndex->skipArray); itrSkip != std::end(newIndex->skipArray); ++itrSkip)
+        {
+            if (nodeCmdArray.contains(itrSkip->first) != true)
+            {
+                itrSkip->second.push_back(ip);
+            }
+        }
     }
 
+    this->subscriptionIndex.store(std::move(newIndex));
+
+    return;
+}
+
+// Replays the last values addressed to the node, before any newer one can be sent to it
+void NodeServer::processConnection (boost::asio::ip::address ip)
+{
+    const auto itrNode = std::find(std::cbegin(this->nodeTable), std::cend(this->nodeTable), ip);
+
+    if (itrNode == std::cend(this->nodeTable))
+    {
+        return;
+    }
+
+    const node_id_t node = static_cast<node_id_t>(std::distance(std::cbegin(this->nodeTable), itrNode));
+
+    const auto subscription = this->subscriptionIndex.load();
+    const auto itrSubscription = subscription->nodeArray.find(node);
+
+    std::vector<boost::asio::ip::address> destArray { ip };
+    std::size_t replayCount = 0U;
+
+    std::scoped_lock lock { this->cacheMutex };
+
+    for (auto itr = std::cbegin(this->cache); itr != std::cend(this->cache); ++itr)
+    {
+        const auto &[key, cachedMessage] = *itr;
+        const auto &[source, cmdID] = key;
+
+        if (source == node)
+        {
+            continue;
+        }
+
+        if (cachedMessage.destArray.contains(node) != true)
+        {
+            if (cachedMessage.destArray.contains(NODE_BROADCAST) != true)
+            {
+                continue;
+            }
+
+            if ((itrSubscription != std::cend(subscription->nodeArray)) && (itrSubscription->second.contains(cmdID) != true))
+            {
+                continue;
+            }
+        }
+
+        this->server->sendMessage(destArray, cachedMessage.message);
+        ++replayCount;
+    }
+
+    BOOST_LOG_TRIVIAL(info) << "Node Server : node[" << node << "] replayed message count = " << replayCount;
+
     return;
 }
@@ -6,11 +6,19 @@
 #ifndef NODE_SERVER_H_
 #define NODE_SERVER_H_
 
+#include <map>
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <string_view>
+
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/ip/address.hpp>
 
 #include "Node.Type.hpp"
 #include "node/node.list.h"
+#include "node/node.command.h"
 
 namespace TCP
 {
@@ -19,6 +27,11 @@ namespace TCP
 
 class NodeServer
 {
+    public:
+        // State commands, their last values are replayed to the nodes on connection.
+        // Events, such as lights or intrusions, and requests are not cached
+        static constexpr std::array<node_command_id_t, 4U> CACHED_COMMAND_ARRAY { SET_MODE, SET_WARNING, UPDATE_TEMPERATURE, UPDATE_DOOR_STATE };
+
     public:
         explicit NodeServer (boost::asio::io_context &context);
         NodeServer (const NodeServer&) = delete;
@@ -31,8 +44,27 @@ class NodeServer
         void start ();
 
     private:
-        void receiveMessage (std::string message);
-        void redirectMessage (std::string message);
+        void receiveMessage (std::string_view message);
+        void redirectMessage (std::string_view message);
+        void processSubscription (std::string_view message);
+        void processConnection (boost::asio::ip::address ip);
+
+    private:
+        // Immutable snapshot, the redirection reads it without locking
+        struct SubscriptionIndex
+        {
+            std::map<node_id_t, NodeCommandArray> nodeArray;    // Subscribed nodes
+            std::map<node_command_id_t, std::vector<boost::asio::ip::address>> skipArray;  // Subscribed nodes which do not consume the command
+            std::vector<boost::asio::ip::address> defaultSkipArray;   // All the subscribed nodes, for the commands nobody consumes
+        };
+
+        struct CachedMessage
+        {
+            NodeIdArray destArray;
+            std::string message;
+        };
+
+        using CacheKey = std::pair<node_id_t, node_command_id_t>;  // Source, command
 
     private:
         boost::asio::io_context &ioContext;
@@ -40,6 +72,14 @@ class NodeServer
     private:
         std::unique_ptr<TCP::Server> server;
         std::array<boost::asio::ip::address, NODE_LIST_SIZE> nodeTable;
+
+    private:
+        std::mutex subscriptionMutex;   // Serializes the snapshot writers only
+        std::atomic<std::shared_ptr<const SubscriptionIndex>> subscriptionIndex;
+
+    private:
+        std::mutex cacheMutex;  // Held while a cached command is sent, so a replay never overtakes a newer value
+        std::map<CacheKey, CachedMessage> cache;
 };
 
 #endif // NODE_SERVER_H_
@@ -4,6 +4,8 @@
  ************************************************************/
 
 #include <filesystem>
+#include <thread>
+#include <vector>
 
 #include <boost/program_options.hpp>
 #include <boost/log/core.hpp>
@@ -19,6 +21,7 @@
 struct Options
 {
     std::filesystem::path logDirectory;
+    std::size_t threadCount;
 };
 
 
@@ -30,14 +33,29 @@ int main (int argc, char *argv[])
     Options options = parseOptions(argc, argv);
     initLogging(options);
 
-    boost::asio::io_context io_context;
+    boost::asio::io_context io_context { static_cast<int>(options.threadCount) };
     boost::asio::executor_work_guard<boost::asio::io_context::executor_type> work = boost::asio::make_work_guard(io_context);
 
     NodeServer nodeServer { io_context };
     nodeServer.start();
 
+    BOOST_LOG_TRIVIAL(info) << "Server : thread count = " << options.threadCount;
+
+    std::vector<std::thread> threadArray;
+    threadArray.reserve(options.threadCount - 1U);
+
+    for (std::size_t i = 1U; i < options.threadCount; ++i)
+    {
+        threadArray.emplace_back([&io_context] () { io_context.run(); });
+    }
+
     io_context.run();
 
+    for (auto itr = std::begin(threadArray); itr != std::end(threadArray); ++itr)
+    {
+        itr->join();
+    }
+
     return EXIT_SUCCESS;
 }
 
@@ -49,6 +67,7 @@ Options parseOptions (int argc, char *argv[])
     boost::program_options::options_description optionDescription("Options");
     optionDescription.add_options()
         ("log,l", boost::program_options::value<std::filesystem::path>(), "Directory for logging")
+        ("threads,t", boost::program_options::value<std::size_t>()->default_value(1U), "Number of threads running the server")
         ("help,h", "Show help")
         ("version,v", "Show version")
     ;
@@ -75,6 +94,15 @@ Options parseOptions (int argc, char *argv[])
         options.logDirectory = optionMap["log"].as<std::filesystem::path>();
     }
 
+    options.threadCount = optionMap["threads"].as<std::size_t>();
+
+    if (options.threadCount == 0U)
+    {
+        std::cerr << "Thread count must be positive" << std::endl;
+
+        std::exit(EXIT_FAILURE);
+    }
+
     return options;
 }
 
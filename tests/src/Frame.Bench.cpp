@@ -0,0 +1,127 @@
+/************************************************************
+ *   Author : German Mundinger
+ *   Date   : 2024
+ ************************************************************/
+
+#include <benchmark/benchmark.h>
+
+#include <new>
+#include <atomic>
+#include <vector>
+#include <cstdlib>
+
+#include "TCP/Frame.hpp"
+#include "TCP/Connection.hpp"
+
+
+// Count heap traffic of the benchmarked code,
+// the counters are atomic since the replacement serves every thread of the benchmarks binary.
+// The replacements are kept out of line, so the compiler never pairs an inlined malloc with a new expression
+static std::atomic<std::size_t> allocationCount { 0U };
+static std::atomic<std::size_t> allocationBytes { 0U };
+
+[[gnu::noinline]] void* operator new (std::size_t size)
+{
+    allocationCount.fetch_add(1U, std::memory_order_relaxed);
+    allocationBytes.fetch_add(size, std::memory_order_relaxed);
+
+    if (void *memory = std::malloc(size); memory != nullptr)
+    {
+        return memory;
+    }
+    throw std::bad_alloc { };
+}
+
+[[gnu::noinline]] void operator delete (void *memory) noexcept
+{
+    std::free(memory);
+}
+
+[[gnu::noinline]] void operator delete (void *memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+
+static const std::string message = "{\"src_id\":2,\"dst_id\":[0],\"cmd_id\":6,\"data\":{\"hum_pct\":61,\"pres_hpa\":1004,\"temp_c\":21.5}}";
+
+static void reportAllocations (benchmark::State &state, std::size_t count, std::size_t bytes)
+{
+    state.counters["allocs/op"] = benchmark::Counter(static_cast<double>(count), benchmark::Counter::kAvgIterations);
+    state.counters["bytes/op"]  = benchmark::Counter(static_cast<double>(bytes), benchmark::Counter::kAvgIterations);
+}
+
+// Every connection gets its own copy of the message (previous behaviour)
+static void BM_BroadcastCopy (benchmark::State &state)
+{
+    const std::size_t connectionCount = static_cast<std::size_t>(state.range(0));
+
+    std::vector<std::vector<std::string>> queueArray(connectionCount);
+
+    for (auto &queue : queueArray)
+    {
+        queue.reserve(1U);
+    }
+
+    const std::size_t startCount = allocationCount.load(std::memory_order_relaxed);
+    const std::size_t startBytes = allocationBytes.load(std::memory_order_relaxed);
+
+    for (auto _ : state)
+    {
+        std::string source = message;
+
+        for (auto &queue : queueArray)
+        {
+            std::string copy = source;
+
+            if (copy.back() != TCP::Connection::msgDelimiter)
+            {
+                copy.push_back(TCP::Connection::msgDelimiter);
+            }
+            queue.push_back(std::move(copy));
+        }
+
+        for (auto &queue : queueArray)
+        {
+            queue.clear();
+        }
+    }
+
+    reportAllocations(state, allocationCount.load(std::memory_order_relaxed) - startCount, allocationBytes.load(std::memory_order_relaxed) - startBytes);
+}
+
+// One shared frame for all the connections
+static void BM_BroadcastFrame (benchmark::State &state)
+{
+    const std::size_t connectionCount = static_cast<std::size_t>(state.range(0));
+
+    std::vector<std::vector<TCP::Frame>> queueArray(connectionCount);
+
+    for (auto &queue : queueArray)
+    {
+        queue.reserve(1U);
+    }
+
+    const std::size_t startCount = allocationCount.load(std::memory_order_relaxed);
+    const std::size_t startBytes = allocationBytes.load(std::memory_order_relaxed);
+
+    for (auto _ : state)
+    {
+        const TCP::Frame frame = TCP::makeFrame(message);
+
+        for (auto &queue : queueArray)
+        {
+            queue.push_back(frame);
+        }
+
+        for (auto &queue : queueArray)
+        {
+            queue.clear();
+        }
+    }
+
+    reportAllocations(state, allocationCount.load(std::memory_order_relaxed) - startCount, allocationBytes.load(std::memory_order_relaxed) - startBytes);
+}
+
+BENCHMARK(BM_BroadcastCopy)->RangeMultiplier(4)->Range(1, 256);
+BENCHMARK(BM_BroadcastFrame)->RangeMultiplier(4)->Range(1, 256);
@@ -0,0 +1,118 @@
+/************************************************************
+ *   Author : German Mundinger
+ *   Date   : 2024
+ ************************************************************/
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+#include <cstdint>
+
+#include "device/frame_buffer_kernel.h"
+
+
+static constexpr std::size_t screenWidth   = 1280U;
+static constexpr std::size_t screenHeight  = 720U;
+static constexpr std::size_t screenStride  = screenWidth * sizeof(std::uint16_t);
+
+static constexpr std::size_t imageSize     = 128U;     // Square sprite
+static constexpr std::size_t imageStride   = imageSize * sizeof(std::uint32_t);
+
+
+// Premultiplied ARGB32, the alpha goes over the whole range
+static std::vector<std::uint8_t> makeImage ()
+{
+    std::vector<std::uint8_t> image(imageStride * imageSize);
+
+    for (std::size_t i = 0U; i < std::size(image); i += sizeof(std::uint32_t))
+    {
+        const std::uint8_t alpha = static_cast<std::uint8_t>((i / sizeof(std::uint32_t)) % 256U);
+
+        image[i + 0U] = static_cast<std::uint8_t>(alpha / 2U);
+        image[i + 1U] = static_cast<std::uint8_t>(alpha / 3U);
+        image[i + 2U] = alpha;
+        image[i + 3U] = alpha;
+    }
+
+    return image;
+}
+
+static void reportPixels (benchmark::State &state, std::size_t pixelCount)
+{
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * pixelCount));
+    state.SetLabel(frame_buffer_kernel_name());
+}
+
+static void BM_FillScalar (benchmark::State &state)
+{
+    std::vector<std::uint8_t> screen(screenStride * screenHeight);
+
+    for (auto _ : state)
+    {
+        frame_buffer_fill_scalar(screen.data(), screenStride, screenWidth, screenHeight, 0x841FU);
+        benchmark::ClobberMemory();
+    }
+
+    reportPixels(state, screenWidth * screenHeight);
+}
+
+static void BM_Fill (benchmark::State &state)
+{
+    std::vector<std::uint8_t> screen(screenStride * screenHeight);
+
+    for (auto _ : state)
+    {
+        frame_buffer_fill(screen.data(), screenStride, screenWidth, screenHeight, 0x841FU);
+        benchmark::ClobberMemory();
+    }
+
+    reportPixels(state, screenWidth * screenHeight);
+}
+
+static void BM_Copy (benchmark::State &state)
+{
+    std::vector<std::uint8_t> screen(screenStride * screenHeight);
+    const std::vector<std::uint8_t> image(imageSize * imageSize * sizeof(std::uint16_t), 0x5AU);
+
+    for (auto _ : state)
+    {
+        frame_buffer_copy(screen.data(), screenStride, image.data(), imageSize * sizeof(std::uint16_t), imageSize, imageSize);
+        benchmark::ClobberMemory();
+    }
+
+    reportPixels(state, imageSize * imageSize);
+}
+
+static void BM_BlendScalar (benchmark::State &state)
+{
+    std::vector<std::uint8_t> screen(screenStride * screenHeight, 0xA5U);
+    const std::vector<std::uint8_t> image = makeImage();
+
+    for (auto _ : state)
+    {
+        frame_buffer_blend_scalar(screen.data(), screenStride, image.data(), imageStride, imageSize, imageSize);
+        benchmark::ClobberMemory();
+    }
+
+    reportPixels(state, imageSize * imageSize);
+}
+
+static void BM_Blend (benchmark::State &state)
+{
+    std::vector<std::uint8_t> screen(screenStride * screenHeight, 0xA5U);
+    const std::vector<std::uint8_t> image = makeImage();
+
+    for (auto _ : state)
+    {
+        frame_buffer_blend(screen.data(), screenStride, image.data(), imageStride, imageSize, imageSize);
+        benchmark::ClobberMemory();
+    }
+
+    reportPixels(state, imageSize * imageSize);
+}
+
+BENCHMARK(BM_FillScalar);
+BENCHMARK(BM_Fill);
+BENCHMARK(BM_Copy);
+BENCHMARK(BM_BlendScalar);
+BENCHMARK(BM_Blend);
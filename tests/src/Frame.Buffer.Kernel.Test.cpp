@@ -0,0 +1,190 @@
+/************************************************************
+ *   Author : German Mundinger
+ *   Date   : 2024
+ ************************************************************/
+
+#include <gmock/gmock.h>
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+
+#include "device/frame_buffer_kernel.h"
+
+
+// Odd sizes and padded strides, so the vector bodies and the scalar tails are both hit
+static constexpr std::size_t width         = 37U;
+static constexpr std::size_t height        = 5U;
+static constexpr std::size_t targetStride  = (width + 3U) * sizeof(std::uint16_t);
+static constexpr std::size_t sourceStride  = (width + 1U) * sizeof(std::uint32_t);
+
+static std::uint16_t readPixel (const std::vector<std::uint8_t> &buffer, std::size_t x, std::size_t y)
+{
+    std::uint16_t pixel;
+    std::memcpy(&pixel, buffer.data() + (y * targetStride) + (x * sizeof(pixel)), sizeof(pixel));
+
+    return pixel;
+}
+
+// Premultiplied ARGB32, the alpha goes over the whole range
+static std::vector<std::uint8_t> makeSource ()
+{
+    std::vector<std::uint8_t> source(sourceStride * height);
+
+    for (std::size_t y = 0U; y < height; ++y)
+    {
+        for (std::size_t x = 0U; x < width; ++x)
+        {
+            const std::uint32_t alpha = ((x + (y * width)) * 29U) % 256U;
+            const std::uint32_t pixel = (alpha << 24U) | (((alpha * 3U) / 4U) << 16U) | ((alpha / 2U) << 8U) | (alpha / 5U);
+
+            std::memcpy(source.data() + (y * sourceStride) + (x * sizeof(pixel)), &pixel, sizeof(pixel));
+        }
+    }
+
+    return source;
+}
+
+static std::vector<std::uint8_t> makeTarget ()
+{
+    std::vector<std::uint8_t> target(targetStride * height);
+
+    for (std::size_t i = 0U; i < std::size(target); ++i)
+    {
+        target[i] = static_cast<std::uint8_t>((i * 73U) + 11U);
+    }
+
+    return target;
+}
+
+TEST(FrameBufferKernel, PackColor)
+{
+    // Act, Assert
+    EXPECT_EQ(frame_buffer_pack_rgb565(0xFFU, 0xFFU, 0xFFU), 0xFFFFU);
+    EXPECT_EQ(frame_buffer_pack_rgb565(0xFFU, 0x00U, 0x00U), 0xF800U);
+    EXPECT_EQ(frame_buffer_pack_rgb565(0x00U, 0xFFU, 0x00U), 0x07E0U);
+    EXPECT_EQ(frame_buffer_pack_rgb565(0x00U, 0x00U, 0xFFU), 0x001FU);
+}
+
+TEST(FrameBufferKernel, FillKeepsPadding)
+{
+    // Arrange: create and set up a system under test
+    std::vector<std::uint8_t> buffer(targetStride * height, 0xEEU);
+
+    // Act: poke the system under test
+    frame_buffer_fill(buffer.data(), targetStride, width, height, 0x1234U);
+
+    // Assert: make unit test pass or fail
+    for (std::size_t y = 0U; y < height; ++y)
+    {
+        for (std::size_t x = 0U; x < width; ++x)
+        {
+            EXPECT_EQ(readPixel(buffer, x, y), 0x1234U);
+        }
+        EXPECT_EQ(readPixel(buffer, width, y), 0xEEEEU);
+    }
+}
+
+TEST(FrameBufferKernel, BlendMatchesScalar)
+{
+    // Arrange: create and set up a system under test
+    const std::vector<std::uint8_t> source = makeSource();
+    std::vector<std::uint8_t> target = makeTarget();
+
+    std::vector<std::uint8_t> expectedTarget = target;
+
+    // Act: poke the system under test
+    frame_buffer_blend(target.data(), targetStride, source.data(), sourceStride, width, height);
+    frame_buffer_blend_scalar(expectedTarget.data(), targetStride, source.data(), sourceStride, width, height);
+
+    // Assert: make unit test pass or fail
+    EXPECT_EQ(target, expectedTarget) << "kernel = " << frame_buffer_kernel_name();
+}
+
+TEST(FrameBufferKernel, BlendOpaqueAndTransparent)
+{
+    // Arrange: create and set up a system under test
+    std::vector<std::uint8_t> source(sourceStride * height, 0U);   // Transparent
+    std::vector<std::uint8_t> target(targetStride * height);
+
+    frame_buffer_fill(target.data(), targetStride, width, height, 0x1234U);
+
+    const std::uint32_t opaquePixel = 0xFFFF0000U;     // Red
+
+    for (std::size_t y = 0U; y < height; ++y)
+    {
+        std::memcpy(source.data() + (y * sourceStride), &opaquePixel, sizeof(opaquePixel));
+    }
+
+    // Act: poke the system under test
+    frame_buffer_blend(target.data(), targetStride, source.data(), sourceStride, width, height);
+
+    // Assert: make unit test pass or fail
+    for (std::size_t y = 0U; y < height; ++y)
+    {
+        EXPECT_EQ(readPixel(target, 0U, y), 0xF800U);
+
+        for (std::size_t x = 1U; x < width; ++x)
+        {
+            EXPECT_EQ(readPixel(target, x, y), 0x1234U);
+        }
+    }
+}
+
+
+// Every path of the build is forced in turn, the automatic choice alone
+// would leave the SSE2 body untested on an AVX2 processor
+class FrameBufferKernelParamPath : public testing::TestWithParam<frame_buffer_kernel_t>
+{
+    protected:
+        void SetUp () override
+        {
+            if (frame_buffer_kernel_force(GetParam()) != true)
+            {
+                GTEST_SKIP() << "Kernel is not available";
+            }
+        }
+
+        void TearDown () override
+        {
+            frame_buffer_kernel_force(FRAME_BUFFER_KERNEL_AUTO);
+        }
+};
+
+TEST_P(FrameBufferKernelParamPath, FillMatchesScalar)
+{
+    // Arrange: create and set up a system under test
+    std::vector<std::uint8_t> target = makeTarget();
+    std::vector<std::uint8_t> expectedTarget = target;
+
+    // Act: poke the system under test
+    frame_buffer_fill(target.data(), targetStride, width, height, 0x841FU);
+    frame_buffer_fill_scalar(expectedTarget.data(), targetStride, width, height, 0x841FU);
+
+    // Assert: make unit test pass or fail
+    EXPECT_EQ(target, expectedTarget) << "kernel = " << frame_buffer_kernel_name();
+}
+
+TEST_P(FrameBufferKernelParamPath, BlendMatchesScalar)
+{
+    // Arrange: create and set up a system under test
+    const std::vector<std::uint8_t> source = makeSource();
+    std::vector<std::uint8_t> target = makeTarget();
+    std::vector<std::uint8_t> expectedTarget = target;
+
+    // Act: poke the system under test
+    frame_buffer_blend(target.data(), targetStride, source.data(), sourceStride, width, height);
+    frame_buffer_blend_scalar(expectedTarget.data(), targetStride, source.data(), sourceStride, width, height);
+
+    // Assert: make unit test pass or fail
+    EXPECT_EQ(target, expectedTarget) << "kernel = " << frame_buffer_kernel_name();
+}
+
+INSTANTIATE_TEST_SUITE_P(FrameBufferKernel, FrameBufferKernelParamPath,
+    testing::Values(
+        FRAME_BUFFER_KERNEL_SCALAR,
+        FRAME_BUFFER_KERNEL_SSE2,
+        FRAME_BUFFER_KERNEL_AVX2,
+        FRAME_BUFFER_KERNEL_NEON
+    )
+);
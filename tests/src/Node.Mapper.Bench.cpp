@@ -0,0 +1,98 @@
+/************************************************************
+ *   Author : German Mundinger
+ *   Date   : 2024
+ ************************************************************/
+
+#include <benchmark/benchmark.h>
+
+#include "Node.Mapper.hpp"
+
+
+static NodeMsg makeMessage ()
+{
+    NodeMsg msg;
+    msg.header.source = NODE_T01;
+    msg.header.destArray.insert(NODE_B01);
+    msg.header.destArray.insert(NODE_B02);
+
+    msg.cmdID = UPDATE_TEMPERATURE;
+    msg.dataArray.emplace("temp_c", 21.5F);
+    msg.dataArray.emplace("hum_pct", 61);
+    msg.dataArray.emplace("pres_hpa", 1004);
+
+    return msg;
+}
+
+static void BM_Serialize (benchmark::State &state, NODE_CODEC codec)
+{
+    const NodeMsg msg = makeMessage();
+    std::size_t size = 0U;
+
+    for (auto _ : state)
+    {
+        std::string rawData = serialize(msg, codec);
+        size = std::size(rawData);
+
+        benchmark::DoNotOptimize(rawData);
+    }
+
+    state.counters["bytes/msg"] = static_cast<double>(size);
+}
+
+static void BM_DeserializeMessage (benchmark::State &state, NODE_CODEC codec)
+{
+    const std::string rawData = serialize(makeMessage(), codec);
+
+    for (auto _ : state)
+    {
+        NodeMsg msg;
+        deserializeMessage(rawData, msg);
+
+        benchmark::DoNotOptimize(msg);
+    }
+
+    state.counters["bytes/msg"] = static_cast<double>(std::size(rawData));
+}
+
+static void BM_DeserializeHeader (benchmark::State &state, NODE_CODEC codec)
+{
+    const std::string rawData = serialize(makeMessage(), codec);
+
+    for (auto _ : state)
+    {
+        NodeMsgHeader header;
+        deserializeHeader(rawData, header);
+
+        benchmark::DoNotOptimize(header);
+    }
+
+    state.counters["bytes/msg"] = static_cast<double>(std::size(rawData));
+}
+
+// The header cost should not grow with the payload
+static void BM_DeserializeHeaderPayload (benchmark::State &state, NODE_CODEC codec)
+{
+    NodeMsg msg = makeMessage();
+    msg.dataArray.emplace("log", std::string(static_cast<std::size_t>(state.range(0)), 'x'));
+
+    const std::string rawData = serialize(msg, codec);
+
+    for (auto _ : state)
+    {
+        NodeMsgHeader header;
+        deserializeHeader(rawData, header);
+
+        benchmark::DoNotOptimize(header);
+    }
+
+    state.counters["bytes/msg"] = static_cast<double>(std::size(rawData));
+}
+
+BENCHMARK_CAPTURE(BM_Serialize, json, NODE_CODEC::JSON);
+BENCHMARK_CAPTURE(BM_Serialize, binary, NODE_CODEC::BINARY);
+BENCHMARK_CAPTURE(BM_DeserializeMessage, json, NODE_CODEC::JSON);
+BENCHMARK_CAPTURE(BM_DeserializeMessage, binary, NODE_CODEC::BINARY);
+BENCHMARK_CAPTURE(BM_DeserializeHeader, json, NODE_CODEC::JSON);
+BENCHMARK_CAPTURE(BM_DeserializeHeader, binary, NODE_CODEC::BINARY);
+BENCHMARK_CAPTURE(BM_DeserializeHeaderPayload, json, NODE_CODEC::JSON)->RangeMultiplier(8)->Range(8, 4096);
+BENCHMARK_CAPTURE(BM_DeserializeHeaderPayload, binary, NODE_CODEC::BINARY)->RangeMultiplier(8)->Range(8, 4096);
@@ -0,0 +1,218 @@
+/************************************************************
+ *   Author : German Mundinger
+ *   Date   : 2024
+ ************************************************************/
+
+#include <gmock/gmock.h>
+
+#include "Node.Mapper.hpp"
+#include "TCP/Frame.hpp"
+
+
+class NodeMapperParamCodec : public testing::TestWithParam<NODE_CODEC>
+{
+    protected:
+        static NodeMsg makeMessage ()
+        {
+            NodeMsg msg;
+            msg.header.source = NODE_T01;
+            msg.header.destArray.insert(NODE_B01);
+            msg.header.destArray.insert(NODE_B02);
+
+            msg.cmdID = UPDATE_TEMPERATURE;
+            msg.dataArray.emplace("temp_c", -21.5F);
+            msg.dataArray.emplace("pres_hpa", 1004);
+            msg.dataArray.emplace("value_id", -3);
+            msg.dataArray.emplace("log", std::string { "door is open" });
+
+            return msg;
+        }
+};
+
+TEST_P(NodeMapperParamCodec, SerializeDeserializeMessage)
+{
+    // Arrange: create and set up a system under test
+    const NodeMsg expectedMsg = makeMessage();
+
+    // Act: poke the system under test
+    NodeMsg resultMsg;
+    const NODE_MAPPER_ERROR resultError = deserializeMessage(serialize(expectedMsg, GetParam()), resultMsg);
+
+    // Assert: make unit test pass or fail
+    EXPECT_EQ(resultError,                  NODE_MAPPER_ERROR::NONE);
+    EXPECT_EQ(resultMsg.header.source,      expectedMsg.header.source);
+    EXPECT_EQ(resultMsg.header.destArray,   expectedMsg.header.destArray);
+    EXPECT_EQ(resultMsg.cmdID,              expectedMsg.cmdID);
+    EXPECT_EQ(resultMsg.dataArray,          expectedMsg.dataArray);
+}
+
+TEST_P(NodeMapperParamCodec, SerializeDeserializeHeader)
+{
+    // Arrange: create and set up a system under test
+    const NodeMsg expectedMsg = makeMessage();
+
+    // Act: poke the system under test
+    NodeMsgHeader resultHeader;
+    const NODE_MAPPER_ERROR resultError = deserializeHeader(serialize(expectedMsg, GetParam()), resultHeader);
+
+    // Assert: make unit test pass or fail
+    EXPECT_EQ(resultError,              NODE_MAPPER_ERROR::NONE);
+    EXPECT_EQ(resultHeader.source,      expectedMsg.header.source);
+    EXPECT_EQ(resultHeader.destArray,   expectedMsg.header.destArray);
+}
+
+TEST_P(NodeMapperParamCodec, SerializeDeserializeSubscription)
+{
+    // Arrange: create and set up a system under test
+    NodeSubscription expectedSubscription;
+    expectedSubscription.source = NODE_B02;
+    expectedSubscription.cmdArray = { REQUEST_VERSION, SET_MODE, UPDATE_TEMPERATURE };
+
+    const std::string rawData = serializeSubscription(expectedSubscription, GetParam());
+
+    // Act: poke the system under test
+    NodeMsgHeader resultHeader;
+    std::uint32_t resultCmdID;
+    const NODE_MAPPER_ERROR resultRouteError = deserializeRoute(rawData, resultHeader, resultCmdID);
+
+    NodeSubscription resultSubscription;
+    const NODE_MAPPER_ERROR resultError = deserializeSubscription(rawData, resultSubscription);
+
+    // Assert: make unit test pass or fail
+    EXPECT_EQ(resultRouteError,                 NODE_MAPPER_ERROR::NONE);
+    EXPECT_EQ(resultHeader.source,              NODE_B02);
+    EXPECT_TRUE(resultHeader.destArray.empty());
+    EXPECT_EQ(resultCmdID,                      NODE_SUBSCRIBE_CMD_ID);
+    EXPECT_EQ(resultError,                      NODE_MAPPER_ERROR::NONE);
+    EXPECT_EQ(resultSubscription.source,        expectedSubscription.source);
+    EXPECT_EQ(resultSubscription.cmdArray,      expectedSubscription.cmdArray);
+}
+
+INSTANTIATE_TEST_SUITE_P(NodeMapperTest, NodeMapperParamCodec, testing::Values(NODE_CODEC::JSON, NODE_CODEC::BINARY));
+
+
+TEST(NodeMapperTest, DeserializeTruncatedBinaryMessage)
+{
+    // Arrange: create and set up a system under test
+    NodeMsg msg;
+    msg.header.source = NODE_B01;
+    msg.header.destArray.insert(NODE_BROADCAST);
+    msg.cmdID = SET_MODE;
+    msg.dataArray.emplace("value_id", static_cast<int>(GUARD_MODE));
+
+    std::string rawData = serialize(msg, NODE_CODEC::BINARY);
+    rawData.pop_back();
+
+    // Act: poke the system under test
+    NodeMsg resultMsg;
+    const NODE_MAPPER_ERROR resultError = deserializeMessage(rawData, resultMsg);
+
+    // Assert: make unit test pass or fail
+    EXPECT_EQ(resultError, NODE_MAPPER_ERROR::UNEXPECTED_END);
+}
+
+
+TEST(NodeMapperTest, BinaryMessageWithDelimiter)
+{
+    // Arrange: create and set up a system under test
+    NodeMsg expectedMsg;
+    expectedMsg.header.source = NODE_B01;
+    expectedMsg.header.destArray.insert(NODE_BROADCAST);
+    expectedMsg.cmdID = SET_MODE;
+    expectedMsg.dataArray.emplace("log", std::string { "a\nb" });
+    expectedMsg.dataArray.emplace("value_id", 5);    // Zigzag varint 0x0A, the last byte of the message
+
+    const std::string rawData = serialize(expectedMsg, NODE_CODEC::BINARY);
+
+    // Act: poke the system under test
+    const TCP::Frame frame = TCP::makeFrame(rawData);
+
+    NodeMsg resultMsg;
+    const NODE_MAPPER_ERROR resultError = deserializeMessage(frame->message, resultMsg);
+
+    // Assert: make unit test pass or fail
+    EXPECT_EQ(rawData.back(),               '\x0A');
+    EXPECT_FALSE(frame->isText);
+    EXPECT_EQ(frame->message,               rawData);
+    EXPECT_EQ(resultError,                  NODE_MAPPER_ERROR::NONE);
+    EXPECT_EQ(resultMsg.dataArray,          expectedMsg.dataArray);
+}
+
+
+TEST(NodeMapperTest, DeserializeJsonMessage)
+{
+    // Arrange: create and set up a system under test
+    const std::string rawData = " { \"cmd_id\" : " + std::to_string(UPDATE_TEMPERATURE) + ", \"extra\" : { \"list\" : [1, \"}\"] },"
+                                " \"data\" : { \"temp_c\" : -0.5, \"big\" : 3000000000, \"log\" : \"a\\\"b\\u00e9\", \"flag\" : true, \"obj\" : {\"x\":1} },"
+                                " \"dst_id\" : [ " + std::to_string(NODE_B02) + ", " + std::to_string(NODE_B01) + " ], \"src_id\" : " + std::to_string(NODE_T01) + " } ";
+
+    NodeDataArray expectedDataArray;
+    expectedDataArray.emplace("temp_c", -0.5F);
+    expectedDataArray.emplace("big", 3000000000.0F);
+    expectedDataArray.emplace("log", std::string { "a\"b\xC3\xA9" });
+    expectedDataArray.emplace("flag", std::string { "true" });
+    expectedDataArray.emplace("obj", std::string {});
+
+    // Act: poke the system under test
+    NodeMsg resultMsg;
+    const NODE_MAPPER_ERROR resultError = deserializeMessage(rawData, resultMsg);
+
+    // Assert: make unit test pass or fail
+    EXPECT_EQ(resultError,                  NODE_MAPPER_ERROR::NONE);
+    EXPECT_EQ(resultMsg.header.source,      NODE_T01);
+    EXPECT_EQ(resultMsg.header.destArray,   (NodeIdArray { NODE_B01, NODE_B02 }));
+    EXPECT_EQ(resultMsg.cmdID,              UPDATE_TEMPERATURE);
+    EXPECT_EQ(resultMsg.dataArray,          expectedDataArray);
+}
+
+
+TEST(NodeMapperTest, DeserializeJsonHeaderOnly)
+{
+    // Arrange: create and set up a system under test
+    const std::string rawData = "{\"src_id\":" + std::to_string(NODE_B02) + ",\"dst_id\":[" + std::to_string(NODE_BROADCAST) + "],"
+                                "\"cmd_id\":6,\"data\":{\"temp_c\":";
+
+    // Act: poke the system under test
+    NodeMsgHeader resultHeader;
+    const NODE_MAPPER_ERROR resultError = deserializeHeader(rawData, resultHeader);
+
+    // Assert: make unit test pass or fail
+    EXPECT_EQ(resultError,              NODE_MAPPER_ERROR::NONE);
+    EXPECT_EQ(resultHeader.source,      NODE_B02);
+    EXPECT_EQ(resultHeader.destArray,   (NodeIdArray { NODE_BROADCAST }));
+}
+
+
+class NodeMapperParamInvalidJson : public testing::TestWithParam
+    <std::tuple<
+        std::string,
+        NODE_MAPPER_ERROR
+    >>
+{
+};
+
+TEST_P(NodeMapperParamInvalidJson, DeserializeMessage)
+{
+    // Arrange: create and set up a system under test
+    const auto [rawData, expectedError] = GetParam();
+
+    // Act: poke the system under test
+    NodeMsg resultMsg;
+    const NODE_MAPPER_ERROR resultError = deserializeMessage(rawData, resultMsg);
+
+    // Assert: make unit test pass or fail
+    EXPECT_EQ(resultError, expectedError);
+}
+
+INSTANTIATE_TEST_SUITE_P(NodeMapperTest, NodeMapperParamInvalidJson,
+    testing::Values(
+        std::make_tuple("",                                                         NODE_MAPPER_ERROR::UNEXPECTED_END),
+        std::make_tuple("{\"src_id\":0,\"dst_id\":[1],\"cmd_id\":2,\"data\":{}",    NODE_MAPPER_ERROR::UNEXPECTED_END),
+        std::make_tuple("{\"src_id\":0,\"dst_id\":[1],\"cmd_id\":2,\"data\":{}}x",  NODE_MAPPER_ERROR::UNEXPECTED_CHARACTER),
+        std::make_tuple("{\"src_id\":0,\"dst_id\":[1],\"cmd_id\":2}",               NODE_MAPPER_ERROR::MISSING_FIELD),
+        std::make_tuple("{\"src_id\":0,\"dst_id\":[1],\"cmd_id\":2.5,\"data\":{}}", NODE_MAPPER_ERROR::INVALID_NUMBER),
+        std::make_tuple("{\"src_id\":0,\"dst_id\":[1],\"cmd_id\":-1,\"data\":{}}",  NODE_MAPPER_ERROR::INVALID_NUMBER),
+        std::make_tuple("{\"src_id\":0,\"dst_id\":[1],\"cmd_id\":256,\"data\":{}}", NODE_MAPPER_ERROR::UNKNOWN_COMMAND),
+        std::make_tuple("{\"src_id\":0,\"dst_id\":[1],\"cmd_id\":2,\"data\":{\"a\":\"\\q\"}}", NODE_MAPPER_ERROR::INVALID_STRING)
+    )
+);
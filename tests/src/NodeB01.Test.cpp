@@ -339,6 +339,40 @@ TEST_F(NodeB01TestFixture, ProcessRemoteButtonWarningOn)
 }
 
 
+TEST_F(NodeB01TestFixture, CoalesceDoorPirMessages)
+{
+    // Arrange: create and set up a system under test
+    node.processLuminosity(NodeB01::Luminosity { .lux = (NodeB01::DARKNESS_LEVEL_LUX - 1.0F), .isValid = true });
+
+    // Act: poke the system under test
+    node.processDoorMovement((NodeB01::DISPLAY_DURATION_S * 2U * 1000U));
+    node.processDoorMovement((NodeB01::DISPLAY_DURATION_S * 2U * 1000U) + 1U);
+    node.processDoorMovement((NodeB01::DISPLAY_DURATION_S * 2U * 1000U) + 2U);
+    NodeB01::MessageContainer resultArray = node.extractMessages();
+
+    // Assert: make unit test pass or fail
+    ASSERT_EQ(std::size(resultArray), 1U);
+    EXPECT_EQ(resultArray[0].cmdID, SET_LIGHT);
+    EXPECT_TRUE(node.extractMessages().empty());
+}
+
+TEST_F(NodeB01TestFixture, CoalesceModeMessages)
+{
+    // Arrange: create and set up a system under test
+    node.processRemoteButton(REMOTE_CONTROL_BUTTON::TWO, (NodeB01::DISPLAY_DURATION_S * 2U * 1000U));
+    node.processRemoteButton(REMOTE_CONTROL_BUTTON::ZERO, ((NodeB01::DISPLAY_DURATION_S * 2U * 1000U) + 1U));
+
+    // Act: poke the system under test
+    node.processRemoteButton(REMOTE_CONTROL_BUTTON::ONE, ((NodeB01::DISPLAY_DURATION_S * 2U * 1000U) + 2U));
+    NodeB01::MessageContainer resultArray = node.extractMessages();
+
+    // Assert: make unit test pass or fail
+    ASSERT_EQ(std::size(resultArray), 2U);
+    EXPECT_EQ(resultArray[0].cmdID, SET_MODE);
+    EXPECT_EQ(std::get<int>(resultArray[0].dataArray.at("value_id")), static_cast<int>(SILENCE_MODE));
+    EXPECT_EQ(resultArray[1].cmdID, SET_WARNING);
+}
+
 class NodeB01ParamDoorPir : public NodeB01TestFixture, public testing::WithParamInterface
     <std::tuple<
         NodeB01::Luminosity,
@@ -0,0 +1,315 @@
+/************************************************************
+ *   Author : German Mundinger
+ *   Date   : 2024
+ ************************************************************/
+
+#include <benchmark/benchmark.h>
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <utility>
+#include <string_view>
+#include <shared_mutex>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/log/core.hpp>
+#include <boost/log/trivial.hpp>
+#include <boost/log/expressions.hpp>
+
+#include "TCP/Frame.hpp"
+#include "TCP/Connection.hpp"
+#include "TCP/ConcurrentAcceptor.hpp"
+
+
+// Senders call the registry of a real acceptor from several threads, while another thread
+// accepts a connection, stops the oldest one and clears it, as the server does on node churn.
+// The connections are loopback sockets, each from its own 127.0.0.x address
+
+static constexpr std::size_t CONNECTION_COUNT   = 16U;
+static constexpr std::size_t RUNNER_COUNT       = 2U;
+static constexpr long int CHURN_PERIOD_US       = 100;
+
+
+// Previous registry of ConcurrentAcceptor : the base containers behind a shared_mutex
+class SharedMutexAcceptor : public TCP::Acceptor
+{
+    public:
+        using Acceptor::Acceptor;
+
+    protected:
+        virtual std::size_t startConnection (std::shared_ptr<TCP::Connection> connection) override
+        {
+            std::scoped_lock writeLock { this->mutex };
+
+            return this->Acceptor::startConnection(std::move(connection));
+        }
+
+        virtual void stopConnections () override
+        {
+            std::shared_lock readLock { this->mutex };
+
+            this->Acceptor::stopConnections();
+        }
+
+        virtual void sendToAllConnections (const TCP::Frame &frame) override
+        {
+            std::shared_lock readLock { this->mutex };
+
+            this->Acceptor::sendToAllConnections(frame);
+        }
+
+        virtual void sendToConnection (const boost::asio::ip::address &ip, const TCP::Frame &frame) override
+        {
+            std::shared_lock readLock { this->mutex };
+
+            this->Acceptor::sendToConnection(ip, frame);
+        }
+
+        virtual std::size_t clearStoppedConnections () override
+        {
+            std::scoped_lock writeLock { this->mutex };
+
+            return this->Acceptor::clearStoppedConnections();
+        }
+
+        virtual void clearConnections () override
+        {
+            std::scoped_lock writeLock { this->mutex };
+
+            this->Acceptor::clearConnections();
+        }
+
+    private:
+        std::shared_mutex mutex;
+};
+
+// Opens the registry calls of either acceptor to the benchmark
+template <typename AcceptorType>
+class BenchAcceptor : public AcceptorType
+{
+    public:
+        using AcceptorType::AcceptorType;
+
+    public:
+        using AcceptorType::startConnection;
+        using AcceptorType::stopConnections;
+        using AcceptorType::sendToAllConnections;
+        using AcceptorType::sendToConnection;
+        using AcceptorType::clearStoppedConnections;
+        using AcceptorType::clearConnections;
+};
+
+
+template <typename AcceptorType>
+class Environment
+{
+    public:
+        explicit Environment ()
+        :
+            workGuard { context.get_executor() },
+            listener { context, boost::asio::ip::tcp::endpoint { boost::asio::ip::address_v4::loopback(), 0U } }
+        {
+            TCP::Acceptor::Config config;
+            config.port                     = 0U;
+            config.processMessageCallback   = [] (std::string_view) { };
+            config.processErrorCallback     = [] () { };
+
+            this->acceptor = std::make_shared<BenchAcceptor<AcceptorType>>(config, this->context);
+
+            for (std::size_t i = 0U; i < RUNNER_COUNT; ++i)
+            {
+                this->runnerArray.emplace_back([this] () { this->context.run(); });
+            }
+
+            for (std::size_t i = 0U; i < CONNECTION_COUNT; ++i)
+            {
+                this->addConnection();
+            }
+        }
+
+        ~Environment ()
+        {
+            this->acceptor->stopConnections();
+            this->acceptor->clearConnections();
+            this->connectionArray.clear();
+            this->acceptor.reset();
+
+            // The runners return once the peers have read their end of file
+            this->workGuard.reset();
+
+            for (auto &runner : this->runnerArray)
+            {
+                runner.join();
+            }
+        }
+
+    public:
+        void startChurn ()
+        {
+            this->isChurning = true;
+
+            this->churner = std::thread { [this] ()
+            {
+                while (this->isChurning == true)
+                {
+                    this->addConnection();
+
+                    this->connectionArray.front()->stop();
+                    this->connectionArray.pop_front();
+
+                    this->acceptor->clearStoppedConnections();
+
+                    std::this_thread::sleep_for(std::chrono::microseconds(CHURN_PERIOD_US));
+                }
+            }};
+        }
+
+        void stopChurn ()
+        {
+            this->isChurning = false;
+            this->churner.join();
+        }
+
+        // Cycles over the addresses of the live connections
+        boost::asio::ip::address getAddress (std::size_t index) const
+        {
+            return boost::asio::ip::address_v4 { 0x7F000002U + static_cast<std::uint32_t>(index % CONNECTION_COUNT) };
+        }
+
+    public:
+        std::shared_ptr<BenchAcceptor<AcceptorType>> acceptor;
+
+    private:
+        // A loopback pair, the peer end only drains what the connection writes
+        void addConnection ()
+        {
+            auto peer = std::make_shared<boost::asio::ip::tcp::socket>(this->context);
+            peer->open(boost::asio::ip::tcp::v4());
+            peer->bind(boost::asio::ip::tcp::endpoint { this->getAddress(this->addressIndex++), 0U });
+            peer->connect(this->listener.local_endpoint());
+
+            auto socket = std::make_unique<boost::asio::ip::tcp::socket>(boost::asio::make_strand(this->context));
+            this->listener.accept(*socket);
+
+            boost::asio::co_spawn(this->context, drainAsync(std::move(peer)), boost::asio::detached);
+
+            TCP::Connection::Config config;
+            config.processMessageCallback   = [] (std::string_view) { };
+            config.processErrorCallback     = [] () { };
+            config.writeQueueLimit          = TCP::Connection::defaultWriteQueueLimit;
+            config.framing                  = TCP::FRAMING::TEXT;
+
+            auto connection = std::make_shared<TCP::Connection>(config, std::move(socket));
+
+            this->acceptor->startConnection(connection);
+            this->connectionArray.push_back(std::move(connection));
+        }
+
+        static boost::asio::awaitable<void> drainAsync (std::shared_ptr<boost::asio::ip::tcp::socket> peer)
+        {
+            std::vector<char> buffer(64U * 1024U);
+
+            try
+            {
+                while (true)
+                {
+                    co_await peer->async_read_some(boost::asio::buffer(buffer), boost::asio::use_awaitable);
+                }
+            }
+
+            catch (const boost::system::system_error&)
+            {
+                // The connection is stopped
+            }
+
+            co_return;
+        }
+
+    private:
+        boost::asio::io_context context;
+        boost::asio::executor_work_guard<boost::asio::io_context::executor_type> workGuard;
+        std::vector<std::thread> runnerArray;
+        boost::asio::ip::tcp::acceptor listener;
+
+    private:
+        std::deque<std::shared_ptr<TCP::Connection>> connectionArray;  // Oldest first, touched by the churn thread only once it runs
+        std::size_t addressIndex = 0U;
+        std::atomic<bool> isChurning;
+        std::thread churner;
+};
+
+
+static const TCP::Frame frame = TCP::makeFrame("{\"src_id\":0,\"dst_id\":[2],\"cmd_id\":6,\"data\":{\"hum_pct\":61}}");
+
+template <typename AcceptorType>
+static std::unique_ptr<Environment<AcceptorType>> environment;
+
+template <typename AcceptorType>
+static void startEnvironment (benchmark::State &state)
+{
+    if (state.thread_index() == 0)
+    {
+        // The connections log every write, and every stop as an error
+        boost::log::core::get()->set_filter(boost::log::trivial::severity >= boost::log::trivial::fatal);
+
+        environment<AcceptorType> = std::make_unique<Environment<AcceptorType>>();
+        environment<AcceptorType>->startChurn();
+    }
+}
+
+template <typename AcceptorType>
+static void stopEnvironment (benchmark::State &state)
+{
+    if (state.thread_index() == 0)
+    {
+        environment<AcceptorType>->stopChurn();
+        environment<AcceptorType>.reset();
+    }
+}
+
+template <typename AcceptorType>
+static void BM_RegistryBroadcast (benchmark::State &state)
+{
+    startEnvironment<AcceptorType>(state);
+
+    for (auto _ : state)
+    {
+        environment<AcceptorType>->acceptor->sendToAllConnections(frame);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+
+    stopEnvironment<AcceptorType>(state);
+}
+
+template <typename AcceptorType>
+static void BM_RegistryUnicast (benchmark::State &state)
+{
+    startEnvironment<AcceptorType>(state);
+
+    std::size_t index = static_cast<std::size_t>(state.thread_index());
+
+    for (auto _ : state)
+    {
+        environment<AcceptorType>->acceptor->sendToConnection(environment<AcceptorType>->getAddress(index++), frame);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+
+    stopEnvironment<AcceptorType>(state);
+}
+
+BENCHMARK_TEMPLATE(BM_RegistryBroadcast, SharedMutexAcceptor)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_RegistryBroadcast, TCP::ConcurrentAcceptor)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_RegistryUnicast, SharedMutexAcceptor)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_RegistryUnicast, TCP::ConcurrentAcceptor)->ThreadRange(1, 8)->UseRealTime();